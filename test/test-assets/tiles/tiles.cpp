@@ -1,4 +1,5 @@
 #include "tiles.hpp"
+#include "../../test-logging/memoryStats.hpp"
 
 Tile::Tile(sf::Vector2f scale, std::weak_ptr<sf::Texture> texture, sf::IntRect textureRect, 
            std::weak_ptr<sf::Uint8[]> bitmask, bool walkable)
@@ -48,8 +49,11 @@ Tile::Tile(const Tile& other)
 TileMap::TileMap(std::shared_ptr<Tile>* tileTypesArray, unsigned int tileTypesNumber, size_t tileMapWidth, size_t tileMapHeight, float tileWidth, float tileHeight, std::filesystem::path filePath, sf::Vector2f tileMapPosition) 
     : tileTypesNumber(tileTypesNumber), tileMapWidth(tileMapWidth), tileMapHeight(tileMapHeight), tileWidth(tileWidth), tileHeight(tileHeight), tileMapPosition(tileMapPosition) {
 
+    memory::Scope memoryScope(memory::Tag::TileMap);
     try{
         tiles.reserve( tileMapWidth * tileMapHeight ); 
+        tileTypes.reserve( tileMapWidth * tileMapHeight ); 
+        tilePrototypes.assign(tileTypesArray, tileTypesArray + tileTypesNumber);
 
         std::ifstream fileStream(filePath);
         
@@ -72,6 +76,7 @@ TileMap::TileMap(std::shared_ptr<Tile>* tileTypesArray, unsigned int tileTypesNu
                     auto tile = tileTypesArray[tileIndex]->clone();
                     tile->getTileSprite().setPosition(tileMapPosition.x + currentX * tileWidth, tileMapPosition.y + currentY * tileHeight); 
                     tiles.emplace_back(std::move(tile));
+                    tileTypes.push_back(static_cast<std::uint16_t>(tileIndex));
                     
                 } else {
                     throw std::out_of_range("Tile index out of bounds: " + std::to_string(tileIndex));
@@ -83,6 +88,23 @@ TileMap::TileMap(std::shared_ptr<Tile>* tileTypesArray, unsigned int tileTypesNu
 
         fileStream.close();
 
+        // the first snapshot, built from the tiles as loaded; cells the file left out read as blocked type 0
+        auto first = std::make_shared<MapSnapshot>();
+        first->width = tileMapWidth;
+        first->height = tileMapHeight;
+        first->chunksWide = (tileMapWidth + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+        const size_t chunksHigh = (tileMapHeight + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+        std::vector<std::shared_ptr<MapChunk>> chunks(first->chunksWide * chunksHigh);
+        for (auto& chunk : chunks) chunk = std::make_shared<MapChunk>();
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            const size_t x = i % tileMapWidth, y = i / tileMapWidth;
+            MapChunk& chunk = *chunks[(y / MAP_CHUNK_SIZE) * first->chunksWide + x / MAP_CHUNK_SIZE];
+            chunk.types[MapSnapshot::localIndex(x, y)] = tileTypes[i];
+            chunk.walkable[MapSnapshot::localIndex(x, y)] = tiles[i]->getWalkable();
+        }
+        first->chunks.assign(chunks.begin(), chunks.end());
+        std::atomic_store(&published, MapSnapshotHandle(std::move(first)));
+
         log_info("Tile map initialized successfully");
     } catch (const std::exception& e) {
         log_warning("Error in making tilemap: " + std::string(e.what()));
@@ -97,8 +119,33 @@ void TileMap::draw(sf::RenderTarget& target, sf::RenderStates states) const {
     }
 }
 
+void TileMap::buildVertices(const MapSnapshot& snapshot, sf::VertexArray& vertices) const {
+    const size_t cells = std::min(snapshot.getWidth() * snapshot.getHeight(), tiles.size()); // as draw(), cells the file left out stay empty
+    vertices.setPrimitiveType(sf::Quads);
+    vertices.resize(cells * 4);
+    for (size_t i = 0; i < cells; ++i) {
+        sf::Vertex* quad = &vertices[i * 4];
+        const std::uint16_t type = snapshot.tileType(i);
+        if (type >= tilePrototypes.size() || !tilePrototypes[type]) {
+            for (int corner = 0; corner < 4; ++corner) quad[corner] = sf::Vertex(); // nothing drawn for a type the map does not know
+            continue;
+        }
+        const sf::IntRect rect = tilePrototypes[type]->getTextureRect();
+        const sf::Vector2f scale = tilePrototypes[type]->getScale();
+        const sf::Vector2f topLeft(tileMapPosition.x + (i % snapshot.getWidth()) * tileWidth, tileMapPosition.y + (i / snapshot.getWidth()) * tileHeight);
+        const sf::Vector2f size(rect.width * scale.x, rect.height * scale.y);
+        const sf::Vector2f texTopLeft(static_cast<float>(rect.left), static_cast<float>(rect.top));
+
+        quad[0] = sf::Vertex(topLeft, texTopLeft);
+        quad[1] = sf::Vertex(sf::Vector2f(topLeft.x + size.x, topLeft.y), sf::Vector2f(texTopLeft.x + rect.width, texTopLeft.y));
+        quad[2] = sf::Vertex(topLeft + size, sf::Vector2f(texTopLeft.x + rect.width, texTopLeft.y + rect.height));
+        quad[3] = sf::Vertex(sf::Vector2f(topLeft.x, topLeft.y + size.y), sf::Vector2f(texTopLeft.x, texTopLeft.y + rect.height));
+    }
+}
+
 // Add a tile to the map at the specified grid position (x, y)
-void TileMap::addTile(unsigned int x, unsigned int y, std::unique_ptr<Tile> tile) {
+void TileMap::addTile(unsigned int x, unsigned int y, std::unique_ptr<Tile> tile, std::uint16_t tileType) {
+    memory::Scope memoryScope(memory::Tag::TileMap);
     try{
         if (x >= tileMapWidth || y >= tileMapHeight) {
             throw std::out_of_range("Tile position out of bounds: (" + std::to_string(x) + ", " + std::to_string(y) + ")");
@@ -106,6 +153,9 @@ void TileMap::addTile(unsigned int x, unsigned int y, std::unique_ptr<Tile> tile
 
         // Calculate the index in the tiles vector
         unsigned int index = y * tileMapWidth + x;
+        if (index >= tiles.size()) {
+            throw std::out_of_range("Tile position was never loaded: (" + std::to_string(x) + ", " + std::to_string(y) + ")");
+        }
 
         // Ensure the tile is valid (not nullptr)
         if (!tile) {
@@ -117,11 +167,60 @@ void TileMap::addTile(unsigned int x, unsigned int y, std::unique_ptr<Tile> tile
 
         // Optionally set the position of the tile if the Tile class has a method for that
         tiles[index]->getTileSprite().setPosition(tileMapPosition.x + x * tileWidth, tileMapPosition.y + y * tileHeight);
+        ++version;
+
+        if (journal.empty()) journal.resize(TILE_JOURNAL_CAPACITY);
+        journal[(version - 1) % TILE_JOURNAL_CAPACITY] = TileChange { version, index, tileTypes[index], tileType };
+        tileTypes[index] = tileType;
+        writeSnapshot(index, tileType, tiles[index]->getWalkable());
     } catch (const std::exception& e) {
         log_error(e.what()); // Log any exceptions that occur
     }
 }
 
+// copy on write: the first edit of a batch copies the root (chunk pointers only), the first edit of a chunk copies that chunk
+void TileMap::writeSnapshot(size_t index, std::uint16_t tileType, bool walkable) {
+    MapSnapshotHandle current = std::atomic_load(&published);
+    if (!current) return;
+    if (!draft) {
+        draft = std::make_shared<MapSnapshot>(*current);
+        draftChunks.assign(draft->chunks.size(), nullptr);
+    }
+    const size_t x = index % tileMapWidth, y = index / tileMapWidth;
+    const size_t chunkIndex = (y / MAP_CHUNK_SIZE) * draft->chunksWide + x / MAP_CHUNK_SIZE;
+    if (!draftChunks[chunkIndex]) {
+        draftChunks[chunkIndex] = std::make_shared<MapChunk>(*draft->chunks[chunkIndex]);
+        draft->chunks[chunkIndex] = draftChunks[chunkIndex];
+    }
+    draftChunks[chunkIndex]->types[MapSnapshot::localIndex(x, y)] = tileType;
+    draftChunks[chunkIndex]->walkable[MapSnapshot::localIndex(x, y)] = walkable;
+}
+
+void TileMap::publishSnapshot() {
+    if (!draft) return;
+    memory::Scope memoryScope(memory::Tag::TileMap);
+    draft->version = version;
+    std::atomic_store(&published, MapSnapshotHandle(std::move(draft))); // leaves draft null
+    draftChunks.clear();
+}
+
+void TileMap::setTile(unsigned int x, unsigned int y, std::uint16_t tileType) {
+    if (tileType >= tilePrototypes.size() || !tilePrototypes[tileType]) {
+        log_error("Tile type out of range: " + std::to_string(tileType));
+        return;
+    }
+    addTile(x, y, tilePrototypes[tileType]->clone(), tileType);
+}
+
+// versions since + 1 to version are all still in the ring when fewer than TILE_JOURNAL_CAPACITY changes were made since
+bool TileMap::changesSince(std::uint64_t since, std::vector<TileChange>& changes) const {
+    if (since > version || version - since > TILE_JOURNAL_CAPACITY) return false;
+    for (std::uint64_t changed = since + 1; changed <= version; ++changed) {
+        changes.push_back(journal[(changed - 1) % TILE_JOURNAL_CAPACITY]);
+    }
+    return true;
+}
+
 std::unique_ptr<Tile>& TileMap::getTile(size_t index) {
     if (index < tiles.size()) {
         return tiles[index]; // Return the tile at the specified index
@@ -11,6 +11,8 @@
 #include <SFML/Graphics.hpp>
 #include <fstream>
 #include <sstream>
+#include <cstdint>
+#include <array>
 
 #include "../../test-logging/log.hpp"
 
@@ -24,6 +26,7 @@ public:
 
     sf::IntRect const getTextureRect() const { return textureRect; }
     std::weak_ptr<sf::Uint8[]>  const getBitMask() const { return bitmask; }
+    sf::Vector2f const getScale() const { return scale; }
  
     bool getWalkable() const { return walkable; }
     void setWalkable(bool newWalkable) { walkable = newWalkable; }
@@ -45,14 +48,59 @@ private:
     bool walkable {};
 };
 
+// one tile swap, as the TileMap journal keeps it; types are indices into the tile types the map was made with
+struct TileChange {
+    std::uint64_t version; // the map's version once this change was made
+    std::uint32_t index; // y * width + x
+    std::uint16_t oldType;
+    std::uint16_t newType;
+};
+constexpr size_t TILE_JOURNAL_CAPACITY = 4096; // changes kept; a consumer further behind rebuilds from the whole map
+
+constexpr size_t MAP_CHUNK_SIZE = 32; // tiles along each side of a snapshot chunk
+
+// one square of a snapshot; never changed once published, a write copies it
+struct MapChunk {
+    std::array<std::uint16_t, MAP_CHUNK_SIZE * MAP_CHUNK_SIZE> types {};
+    std::array<std::uint8_t, MAP_CHUNK_SIZE * MAP_CHUNK_SIZE> walkable {};
+};
+
+/* Immutable copy of what workers read from a TileMap (tile types and walkability), at one map version. Chunks are shared
+between snapshots, so a new one costs the chunks that were written and a copy of the chunk pointers. Readers hold it by a
+MapSnapshotHandle for as long as they need a consistent map, and read it with no locking while the map goes on changing */
+class MapSnapshot {
+public:
+    size_t getWidth() const { return width; }
+    size_t getHeight() const { return height; }
+    std::uint64_t getVersion() const { return version; }
+
+    std::uint16_t tileType(size_t x, size_t y) const { return chunkAt(x, y).types[localIndex(x, y)]; }
+    bool isWalkable(size_t x, size_t y) const { return chunkAt(x, y).walkable[localIndex(x, y)]; }
+    std::uint16_t tileType(size_t index) const { return tileType(index % width, index / width); }
+    bool isWalkable(size_t index) const { return isWalkable(index % width, index / width); }
+    size_t getChunkCount() const { return chunks.size(); }
+    const MapChunk* getChunk(size_t index) const { return chunks[index].get(); } // the same pointer in snapshots that share it
+
+private:
+    friend class TileMap;
+    const MapChunk& chunkAt(size_t x, size_t y) const { return *chunks[(y / MAP_CHUNK_SIZE) * chunksWide + x / MAP_CHUNK_SIZE]; }
+    static size_t localIndex(size_t x, size_t y) { return (y % MAP_CHUNK_SIZE) * MAP_CHUNK_SIZE + x % MAP_CHUNK_SIZE; }
+
+    size_t width = 0, height = 0; // in tiles; x < width and y < height are for the caller to check
+    size_t chunksWide = 0;
+    std::uint64_t version = 0;
+    std::vector<std::shared_ptr<const MapChunk>> chunks; // row by row
+};
+using MapSnapshotHandle = std::shared_ptr<const MapSnapshot>;
+
 class TileMap : public sf::Drawable {
 public:
     // Constructor now accepts a shared_ptr to a default tile, and initializes the map with it
     explicit TileMap(std::shared_ptr<Tile>* tileTypesArray, unsigned int tileTypesNumber, size_t tileMapWidth, size_t tileMapHeight, float tileWidth, float tileHeight, std::filesystem::path filePath, sf::Vector2f tileMapPosition);
     ~TileMap() = default;
     
-    // Add a tile to the map at the specified grid position (x, y)
-    void addTile(unsigned int x, unsigned int y, std::unique_ptr<Tile> tile); 
+    // puts a fresh copy of the tile type the map was made with at grid position (x, y); every change goes in the journal
+    void setTile(unsigned int x, unsigned int y, std::uint16_t tileType);
     float const getTileWidth() const { return tileWidth; }
     float const getTileHeight() const { return tileHeight; }
     size_t const getTileMapWidth() const { return tileMapWidth; }
@@ -62,8 +110,31 @@ public:
     bool const getVisibleState() const { return visibleState; }
     void setVisibleState(bool newVisibleState) { visibleState = newVisibleState; }
     std::unique_ptr<Tile>& getTile(size_t index);
+    std::uint16_t getTileType(size_t index) const { return index < tileTypes.size() ? tileTypes[index] : 0; }
+    std::uint64_t getVersion() const { return version; } // bumped by every setTile; caches built from the map compare it
+
+    /* appends the changes made after version since to changes, oldest first, so a structure derived from the map can patch
+    just those cells. False when the journal no longer reaches back that far (or since is not a version of this map): the
+    caller has to rebuild from the whole map */
+    bool changesSince(std::uint64_t since, std::vector<TileChange>& changes) const;
+
+    /* the last published snapshot; safe to take from any thread. Edits reach it only at publishSnapshot, which the editing
+    thread calls once it is done with a batch (the game scene does once per tick), so workers never see half an edit.
+    Taking the handle is not lock-free: the std::atomic_load / std::atomic_store overloads for shared_ptr lock a mutex from a
+    small pool the standard library keeps, shared with every other such call, and publishSnapshot takes the same lock. The
+    lock is only held while a pointer and a reference count change, so take the handle once per cast, job or frame, never
+    per tile */
+    MapSnapshotHandle snapshot() const { return std::atomic_load(&published); }
+    void publishSnapshot();
+
+    /* four vertices per cell of snapshot, placed and textured the way draw() places the tiles, for a renderer that must not
+    touch the live map. Texture rects come from the tile types the map was made with, which never change */
+    void buildVertices(const MapSnapshot& snapshot, sf::VertexArray& vertices) const;
 
 private:
+    // behind setTile, which checks tileType and makes tile from it, so the journal and snapshots never disagree with tiles
+    void addTile(unsigned int x, unsigned int y, std::unique_ptr<Tile> tile, std::uint16_t tileType); 
+
     unsigned int tileTypesNumber {};
     size_t tileMapWidth{};
     size_t tileMapHeight{}; 
@@ -72,8 +143,17 @@ private:
     float tileHeight {};
 
     std::vector<std::unique_ptr<Tile>> tiles; 
+    std::vector<std::uint16_t> tileTypes; // per cell, the type it was loaded or last set with
+    std::vector<std::shared_ptr<Tile>> tilePrototypes; // the tile types, for setTile
+    std::vector<TileChange> journal; // ring of the last TILE_JOURNAL_CAPACITY changes; version v's at (v - 1) % capacity
+
+    void writeSnapshot(size_t index, std::uint16_t tileType, bool walkable);
+    MapSnapshotHandle published; // only through std::atomic_load / std::atomic_store (pool-locked, see snapshot())
+    std::shared_ptr<MapSnapshot> draft; // the next snapshot while edits are pending, else null
+    std::vector<std::shared_ptr<MapChunk>> draftChunks; // chunks already copied for the draft, writable in place
     sf::Vector2f tileMapPosition; 
     bool visibleState = true;
+    std::uint64_t version = 0;
 
     // Override the draw function of sf::Drawable to draw all tiles
     virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
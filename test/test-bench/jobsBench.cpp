@@ -0,0 +1,69 @@
+//
+//  jobsBench.cpp
+//  sfml game template
+//
+//  Scaling benchmark for the job system: the same embarrassingly parallel loop is run with 1, 2, 4 ... threads and the
+//  speedup over the single-threaded run is printed. Build and run with `make bench_jobs`.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+
+#include "game/jobs/jobs.hpp"
+
+namespace {
+    constexpr size_t ITEM_COUNT = 1 << 20;
+    constexpr int REPEATS = 5;
+
+    // a few hundred cycles of independent math per item, about the cost of marching one ray
+    float workItem(size_t i) {
+        float value = static_cast<float>(i) * 0.001f;
+        for (int step = 0; step < 48; ++step) value = std::sin(value) * 0.5f + std::sqrt(value + 1.0f);
+        return value;
+    }
+
+    float runLoop(jobs::JobSystem& system, std::vector<float>& output) {
+        float best = 1e9f;
+        for (int repeat = 0; repeat < REPEATS; ++repeat) {
+            Timer timer;
+            system.parallelFor(0, output.size(), [&output](size_t i) { output[i] = workItem(i); });
+            best = std::min(best, timer.ElapsedMillis());
+        }
+        return best;
+    }
+}
+
+int main() {
+    std::vector<float> reference(ITEM_COUNT);
+    for (size_t i = 0; i < ITEM_COUNT; ++i) reference[i] = workItem(i);
+
+    unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < hardwareThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(hardwareThreads);
+
+    std::cout << "parallelFor over " << ITEM_COUNT << " items, best of " << REPEATS << " runs\n";
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "ms" << std::setw(10) << "speedup" << std::setw(12) << "efficiency" << '\n';
+
+    float singleThreadMs = 0.0f;
+    for (unsigned threads : threadCounts) {
+        std::vector<float> output(ITEM_COUNT);
+        float ms = 0.0f;
+        {
+            jobs::JobSystem system(threads - 1); // the calling thread is the last one
+            ms = runLoop(system, output);
+        }
+        if (output != reference) {
+            std::cerr << "parallelFor produced wrong results with " << threads << " threads\n";
+            return 1;
+        }
+
+        if (threads == 1) singleThreadMs = ms;
+        float speedup = singleThreadMs / ms;
+        std::cout << std::setw(8) << threads << std::setw(12) << std::fixed << std::setprecision(2) << ms
+                  << std::setw(10) << speedup << std::setw(11) << std::setprecision(0) << speedup / threads * 100.0f << "%\n";
+    }
+    return 0;
+}
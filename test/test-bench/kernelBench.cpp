@@ -0,0 +1,556 @@
+//
+//  kernelBench.cpp
+//  sfml game template
+//
+//  Catch2 micro-benchmarks of the engine's hot kernels: the raycaster, maze generation, path instructions, the quadtree,
+//  pixel-perfect collision, bitmask creation and tilemap loading, next to checks (plain TEST_CASEs) that the raycaster
+//  agrees with the one-pass cast it replaced, and that the tile map's edit journal and its consumers agree with rebuilding
+//  from scratch. Every random input comes from a fixed seed and nothing opens a window (textures still need the graphics
+//  driver SFML creates its hidden context with). Build and run with `make bench`; Catch2's own options pass through
+//  BENCH_ARGS, e.g. `make bench BENCH_ARGS="[raycast]"`. The perf gate options (--perf-out, --perf-baseline,
+//  --perf-threshold) are described in perfGate.hpp.
+//
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <fstream>
+#include <filesystem>
+#include <catch2/catch_all.hpp>
+
+#include "game/globals/globals.hpp"
+#include "game/physics/physics.hpp"
+#include "game/navigation/corridorGraph.hpp"
+#include "perfGate.hpp"
+
+namespace {
+    constexpr std::uint32_t BENCH_SEED = 12345;
+    constexpr size_t RAY_COUNTS[] = { 200, 800, 3200 };
+    constexpr size_t MAZE_SIZES[] = { 51, 201, 401 };
+    constexpr size_t STRESS_MAZE_SIZE = 8001; // bitboard generators only
+    constexpr size_t QUADTREE_SPRITES[] = { 64, 512 };
+
+    std::filesystem::path scratchFile(const char* name) { return std::filesystem::temp_directory_path() / name; }
+
+    // the game's tile types and the tilemap file they are read with
+    struct TileSet {
+        std::array<std::shared_ptr<Tile>, Constants::TILES_NUMBER> types;
+        std::filesystem::path mapPath;
+
+        TileSet() : mapPath(scratchFile("kernel_bench_tilemap.txt")) {
+            for (int i = 0; i < Constants::TILES_NUMBER; ++i) {
+                types.at(i) = std::make_shared<Tile>(Constants::TILES_SCALE, Constants::TILES_TEXTURE, Constants::TILES_SINGLE_RECTS[i], Constants::TILES_BITMASKS[i], Constants::TILES_BOOLS[i]);
+            }
+            Constants::writeRandomTileMap(mapPath, Constants::DFSmazeGenerator);
+        }
+
+        std::unique_ptr<TileMap> load() {
+            return std::make_unique<TileMap>(types.data(), Constants::TILES_NUMBER, Constants::TILEMAP_WIDTH, Constants::TILEMAP_HEIGHT, Constants::TILE_WIDTH, Constants::TILE_HEIGHT, mapPath, Constants::TILEMAP_POSITION);
+        }
+    };
+
+    TileSet& tileSet() {
+        static TileSet set;
+        return set;
+    }
+
+    // maze generators read their size from the config; restores it when the benchmark is done
+    struct MazeSize {
+        size_t width = Constants::TILEMAP_WIDTH, height = Constants::TILEMAP_HEIGHT;
+        explicit MazeSize(size_t size) { Constants::TILEMAP_WIDTH = Constants::TILEMAP_HEIGHT = size; }
+        ~MazeSize() {
+            Constants::TILEMAP_WIDTH = width;
+            Constants::TILEMAP_HEIGHT = height;
+        }
+    };
+
+    // a DFS maze of size x size, loaded with the tile set's types; for checks that need more than the configured map
+    std::unique_ptr<TileMap> loadMaze(size_t size) {
+        MazeSize mazeSize(size);
+        const std::filesystem::path mapPath = scratchFile("kernel_bench_maze.txt");
+        Constants::writeRandomTileMap(mapPath, Constants::DFSmazeGenerator);
+        auto tileMap = std::make_unique<TileMap>(tileSet().types.data(), Constants::TILES_NUMBER, size, size, Constants::TILE_WIDTH, Constants::TILE_HEIGHT, mapPath, Constants::TILEMAP_POSITION);
+        std::filesystem::remove(mapPath);
+        return tileMap;
+    }
+
+    // an interior cell turned into a wall or a floor at random
+    void randomEdit(TileMap& tileMap, std::mt19937& rng) {
+        const unsigned x = 1 + rng() % (tileMap.getTileMapWidth() - 2), y = 1 + rng() % (tileMap.getTileMapHeight() - 2);
+        tileMap.setTile(x, y, rng() % 2 ? Constants::TILE_WALLINDEX : Constants::TILE_WALKABLEINDEX);
+    }
+
+    // a camera somewhere inside a walkable tile, facing anywhere
+    physics::CameraPose randomPose(TileMap& tileMap, std::mt19937& rng) {
+        const size_t width = tileMap.getTileMapWidth(), height = tileMap.getTileMapHeight();
+        size_t tile = 0;
+        do tile = rng() % (width * height); while (!tileMap.getTile(tile)->getWalkable());
+        std::uniform_real_distribution<float> inside(0.1f, 0.9f), heading(0.0f, 360.0f);
+        return { { Constants::TILEMAP_POSITION.x + (tile % width + inside(rng)) * Constants::TILE_WIDTH,
+                   Constants::TILEMAP_POSITION.y + (tile / width + inside(rng)) * Constants::TILE_HEIGHT }, heading(rng) };
+    }
+
+    /* the raycaster as it was before the cast was split from the geometry: every ray marched and turned into its wall quad in
+    one pass, reading the live tiles. Kept, serial, only as the reference castColumns and buildWallQuads are checked against */
+    void referenceWallQuads(const physics::CameraPose& pose, TileMap& tileMap, sf::VertexArray& wallLine, std::vector<sf::Vector2f>& hitPoints) {
+        const size_t itCount = Constants::RAYS_NUM / 2;
+        const float screenWidth = static_cast<float>(MetaComponents::bigView.getSize().x);
+        const float centerY = static_cast<float>(MetaComponents::bigView.getSize().y) / 2.0f;
+        const float wallHeightScale = 2500.0f, maxRayDistance = 1000.0f, maxDistance = 100.0f, stepSize = 1.0f;
+        const float angleStep = Constants::FOV / static_cast<float>(itCount);
+        const float sliceWidth = screenWidth / static_cast<float>(itCount);
+        const std::vector<sf::Vector2u>& mipOffsets = Constants::TILES_MIP_OFFSETS;
+
+        wallLine.clear();
+        wallLine.setPrimitiveType(sf::Quads);
+        hitPoints.clear();
+        for (size_t i = 0; i < itCount; ++i) {
+            float rayAngle = pose.headingAngle + (i - itCount / 2.0f) * angleStep;
+            float radian = rayAngle * 3.14159f / 180.0f;
+            float dirX = cos(radian);
+            float dirY = sin(radian);
+            float rayX = pose.origin.x, rayY = pose.origin.y, rayDistance = 0.0f;
+
+            while (rayDistance < maxRayDistance) {
+                rayX += dirX * stepSize;
+                rayY += dirY * stepSize;
+                rayDistance += stepSize;
+                int tileX = static_cast<int>(rayX) / tileMap.getTileWidth();
+                int tileY = static_cast<int>(rayY) / tileMap.getTileHeight();
+                if (tileX < 0 || tileY < 0 || tileX >= tileMap.getTileMapWidth() || tileY >= tileMap.getTileMapHeight()) break;
+                auto& tile = tileMap.getTile(tileY * tileMap.getTileMapWidth() + tileX);
+                if (tile->getWalkable()) continue;
+
+                float correctedDistance = std::max(1.0f, rayDistance * cos((rayAngle - pose.headingAngle) * 3.14159f / 180.0f));
+                float wallHeight = wallHeightScale / correctedDistance;
+                float screenX = i * sliceWidth;
+                float wallTopY = centerY - wallHeight / 2.0f;
+                float wallBottomY = centerY + wallHeight / 2.0f;
+                float brightnessFactor = std::max(0.2f, 1.0f - (correctedDistance / maxDistance));
+                sf::Uint8 color = static_cast<sf::Uint8>(50 + 150 * brightnessFactor);
+                sf::Color wallColor(color, color, color);
+
+                sf::Vector2f texStart, texEnd;
+                if (!mipOffsets.empty()) {
+                    const sf::IntRect textureRect = tile->getTextureRect();
+                    const bool sideFace = static_cast<int>(rayX - dirX * stepSize) / static_cast<int>(tileMap.getTileWidth()) != tileX;
+                    float along = sideFace ? std::fmod(rayY, tileMap.getTileHeight()) / tileMap.getTileHeight() : std::fmod(rayX, tileMap.getTileWidth()) / tileMap.getTileWidth();
+                    if (sideFace ? dirX < 0.0f : dirY > 0.0f) along = 1.0f - along;
+                    const size_t level = physics::wallMipLevel(textureRect.height / wallHeight, mipOffsets.size());
+                    const float levelScale = 1.0f / static_cast<float>(1u << level);
+                    const float texelColumn = std::floor((textureRect.left + std::min(along, 0.999f) * textureRect.width) * levelScale) + 0.5f;
+                    texStart = { mipOffsets[level].x + texelColumn, mipOffsets[level].y + textureRect.top * levelScale };
+                    texEnd = { texStart.x, texStart.y + textureRect.height * levelScale };
+                }
+                wallLine.append(sf::Vertex(sf::Vector2f(screenX, wallTopY), wallColor, texStart));
+                wallLine.append(sf::Vertex(sf::Vector2f(screenX + sliceWidth, wallTopY), wallColor, texStart));
+                wallLine.append(sf::Vertex(sf::Vector2f(screenX + sliceWidth, wallBottomY), wallColor, texEnd));
+                wallLine.append(sf::Vertex(sf::Vector2f(screenX, wallBottomY), wallColor, texEnd));
+                hitPoints.emplace_back(rayX, rayY);
+                break;
+            }
+        }
+    }
+
+    // columns where two casts disagree; what ColumnHits keeps for hits only is compared on hits only
+    size_t differentColumns(const physics::ColumnHits& a, const physics::ColumnHits& b) {
+        if (a.size() != b.size() || a.origin != b.origin || a.headingAngle != b.headingAngle) return std::max<size_t>(1, std::max(a.size(), b.size()));
+        size_t different = 0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            bool same = a.rayAngle[i] == b.rayAngle[i] && a.distance[i] == b.distance[i] && a.end[i] == b.end[i] && a.face[i] == b.face[i];
+            if (same && a.face[i] != physics::WallFace::None) {
+                same = a.correctedDistance[i] == b.correctedDistance[i] && a.tile[i] == b.tile[i] && a.tileType[i] == b.tileType[i]
+                       && a.faceCoordinate[i] == b.faceCoordinate[i];
+            }
+            different += !same;
+        }
+        return different;
+    }
+
+    bool sameVertex(const sf::Vertex& a, const sf::Vertex& b) {
+        return a.position == b.position && a.color == b.color && a.texCoords == b.texCoords;
+    }
+
+    /* pixelPerfectCollision reads one byte per colour channel (4 per pixel, 1 where opaque) rather than the packed bits
+    createBitmask writes, so it is fed masks laid out that way */
+    std::shared_ptr<sf::Uint8[]> channelMask(const std::shared_ptr<sf::Uint8[]>& bits, unsigned width, unsigned height) {
+        std::shared_ptr<sf::Uint8[]> mask(new sf::Uint8[width * height * 4](), std::default_delete<sf::Uint8[]>());
+        for (unsigned pixel = 0; pixel < width * height; ++pixel) mask[pixel * 4] = bits && (bits[pixel / 8] >> (pixel % 8) & 1);
+        return mask;
+    }
+}
+
+TEST_CASE("raycaster", "[raycast]") {
+    std::unique_ptr<TileMap> tileMap = tileSet().load();
+    const size_t spawn = Constants::TILEPATH_INSTRUCTION.empty() ? Constants::TILEMAP_WIDTH + 1 : Constants::TILEPATH_INSTRUCTION.back();
+    const sf::Vector2f origin { Constants::TILEMAP_POSITION.x + (spawn % Constants::TILEMAP_WIDTH + 0.5f) * Constants::TILE_WIDTH,
+                                Constants::TILEMAP_POSITION.y + (spawn / Constants::TILEMAP_WIDTH + 0.5f) * Constants::TILE_HEIGHT };
+    const size_t configuredRays = Constants::RAYS_NUM;
+    sf::VertexArray rays, wallLine;
+    physics::ColumnHits hits;
+
+    for (size_t rayCount : RAY_COUNTS) {
+        Constants::RAYS_NUM = rayCount;
+        float heading = 0.0f;
+        BENCHMARK("calculateRayCast3d " + std::to_string(rayCount) + " rays") {
+            heading = std::fmod(heading + 7.0f, 360.0f); // a different view each run, the same sequence every time
+            physics::calculateRayCast3d(origin, heading, tileMap, rays, wallLine);
+            return wallLine.getVertexCount();
+        };
+        BENCHMARK("castColumns " + std::to_string(rayCount) + " rays") {
+            heading = std::fmod(heading + 7.0f, 360.0f);
+            physics::castColumns(origin, heading, *tileMap, hits);
+            return hits.size();
+        };
+        physics::VisibleTiles visible;
+        BENCHMARK("castColumns visible tiles " + std::to_string(rayCount) + " rays") { // against the plain cast: the cost of the set
+            heading = std::fmod(heading + 7.0f, 360.0f);
+            physics::castColumns(origin, heading, *tileMap, hits, &visible);
+            return visible.getBounds().width;
+        };
+        BENCHMARK("buildWallQuads " + std::to_string(rayCount) + " rays") {
+            physics::buildWallQuads(hits, wallLine);
+            return wallLine.getVertexCount();
+        };
+
+        // four views of the same map in one dispatch; compare with four times castColumns
+        std::vector<physics::CameraPose> cameras;
+        for (float offset : { 0.0f, 90.0f, 180.0f, 270.0f }) cameras.push_back({ origin, offset });
+        std::vector<physics::ColumnHits> cameraHits;
+        BENCHMARK("castColumns 4 cameras " + std::to_string(rayCount) + " rays") {
+            heading = std::fmod(heading + 7.0f, 360.0f);
+            for (auto& camera : cameras) camera.headingAngle = std::fmod(camera.headingAngle + 7.0f, 360.0f);
+            physics::castColumns(cameras, *tileMap, cameraHits);
+            return cameraHits.size();
+        };
+    }
+    Constants::RAYS_NUM = configuredRays;
+}
+
+// the split raycaster against the one-pass cast it replaced: the same walls, vertex for vertex, from the same points
+TEST_CASE("raycaster matches the one-pass cast", "[raycast][checks]") {
+    std::unique_ptr<TileMap> tileMap = loadMaze(MAZE_SIZES[0]);
+    std::mt19937 rng(BENCH_SEED);
+    physics::ColumnHits hits;
+    sf::VertexArray wallLine, referenceLine;
+    std::vector<sf::Vector2f> referenceHits;
+
+    // without a graphics driver the mip chain is not built; a made-up layout still exercises the texel column math
+    struct MipLayout {
+        std::vector<sf::Vector2u> built = Constants::TILES_MIP_OFFSETS;
+        MipLayout() { if (built.empty()) Constants::TILES_MIP_OFFSETS = { { 0, 0 }, { 0, 512 }, { 0, 768 }, { 0, 896 } }; }
+        ~MipLayout() { Constants::TILES_MIP_OFFSETS = built; }
+    } mipLayout;
+
+    for (int poseIndex = 0; poseIndex < 200; ++poseIndex) {
+        const physics::CameraPose pose = randomPose(*tileMap, rng);
+        INFO("pose " << poseIndex << " at (" << pose.origin.x << ", " << pose.origin.y << ") heading " << pose.headingAngle);
+        physics::castColumns(pose.origin, pose.headingAngle, *tileMap, hits);
+        physics::buildWallQuads(hits, wallLine);
+        referenceWallQuads(pose, *tileMap, referenceLine, referenceHits);
+
+        REQUIRE(wallLine.getVertexCount() == referenceLine.getVertexCount());
+        size_t differentVertices = 0;
+        for (size_t i = 0; i < wallLine.getVertexCount(); ++i) differentVertices += !sameVertex(wallLine[i], referenceLine[i]);
+        REQUIRE(differentVertices == 0);
+
+        std::vector<sf::Vector2f> hitPoints;
+        for (size_t i = 0; i < hits.size(); ++i) {
+            if (hits.face[i] != physics::WallFace::None) hitPoints.push_back(hits.end[i]);
+        }
+        REQUIRE(hitPoints == referenceHits);
+    }
+}
+
+// several cameras in one dispatch against one cast each: the same columns per camera, and the visible set is their union
+TEST_CASE("batched cameras match single casts", "[raycast][checks]") {
+    std::unique_ptr<TileMap> tileMap = loadMaze(MAZE_SIZES[0]);
+    const size_t tileCount = tileMap->getTileMapWidth() * tileMap->getTileMapHeight();
+    std::mt19937 rng(BENCH_SEED);
+    std::vector<physics::CameraPose> cameras(7);
+    std::vector<physics::ColumnHits> batched;
+    physics::ColumnHits single;
+    physics::VisibleTiles batchedVisible, singleVisible;
+
+    for (int round = 0; round < 20; ++round) {
+        INFO("round " << round);
+        for (auto& camera : cameras) camera = randomPose(*tileMap, rng);
+        physics::castColumns(cameras, *tileMap, batched, &batchedVisible);
+        REQUIRE(batched.size() == cameras.size());
+
+        std::vector<std::uint8_t> seen(tileCount, 0);
+        for (size_t camera = 0; camera < cameras.size(); ++camera) {
+            INFO("camera " << camera);
+            physics::castColumns(cameras[camera].origin, cameras[camera].headingAngle, *tileMap, single, &singleVisible);
+            REQUIRE(differentColumns(batched[camera], single) == 0);
+            for (size_t tile = 0; tile < tileCount; ++tile) seen[tile] |= singleVisible.contains(tile);
+        }
+        size_t differentTiles = 0;
+        for (size_t tile = 0; tile < tileCount; ++tile) differentTiles += batchedVisible.contains(tile) != static_cast<bool>(seen[tile]);
+        REQUIRE(differentTiles == 0);
+    }
+}
+
+TEST_CASE("maze generators", "[maze]") {
+    const std::filesystem::path mazePath = scratchFile("kernel_bench_maze.txt");
+    for (size_t size : MAZE_SIZES) {
+        MazeSize resized(size);
+        const std::string label = std::to_string(size) + "x" + std::to_string(size);
+        BENCHMARK("DFSmazeGenerator " + label) {
+            std::ofstream file(mazePath);
+            Constants::DFSmazeGenerator(file, Constants::TILE_STARTINGINDEX, Constants::TILE_ENDINGINDEX, Constants::TILE_WALKABLEINDEX, Constants::TILE_WALLINDEX);
+        };
+        BENCHMARK("PrimsMazeGenerator " + label) {
+            std::ofstream file(mazePath);
+            Constants::PrimsMazeGenerator(file, Constants::TILE_STARTINGINDEX, Constants::TILE_ENDINGINDEX, Constants::TILE_WALKABLEINDEX, Constants::TILE_WALLINDEX);
+        };
+
+        BENCHMARK("SidewinderMazeGenerator " + label) {
+            std::ofstream file(mazePath);
+            Constants::SidewinderMazeGenerator(file, Constants::TILE_STARTINGINDEX, Constants::TILE_ENDINGINDEX, Constants::TILE_WALKABLEINDEX, Constants::TILE_WALLINDEX);
+        };
+
+        Constants::writeRandomTileMap(mazePath, Constants::DFSmazeGenerator);
+        BENCHMARK("AstarPathInstructionGenerator " + label) {
+            navigation::mazePathCache().clear(); // a cold solve; the cached one is timed next
+            std::ifstream file(mazePath);
+            Constants::AstarPathInstructionGenerator(file, Constants::TILE_STARTINGINDEX, Constants::TILE_ENDINGINDEX, Constants::TILE_WALKABLEINDEX, Constants::TILE_WALLINDEX,
+                                                     static_cast<unsigned short>(size), static_cast<unsigned short>(size));
+            return Constants::TILEPATH_INSTRUCTION.size();
+        };
+        BENCHMARK("AstarPathInstructionGenerator cached " + label) { // the maze is read and hashed, the route comes from the cache
+            std::ifstream file(mazePath);
+            Constants::AstarPathInstructionGenerator(file, Constants::TILE_STARTINGINDEX, Constants::TILE_ENDINGINDEX, Constants::TILE_WALKABLEINDEX, Constants::TILE_WALLINDEX,
+                                                     static_cast<unsigned short>(size), static_cast<unsigned short>(size));
+            return Constants::TILEPATH_INSTRUCTION.size();
+        };
+    }
+    std::filesystem::remove(mazePath);
+    Constants::generateTilePathInstruction(tileSet().mapPath, Constants::AstarPathInstructionGenerator); // back to the config's maze
+
+    // the compact generators alone, on a map far past what the file based ones can make
+    const std::string label = std::to_string(STRESS_MAZE_SIZE) + "x" + std::to_string(STRESS_MAZE_SIZE);
+    Constants::MazeBits bits(STRESS_MAZE_SIZE, STRESS_MAZE_SIZE);
+    std::uint64_t seed = BENCH_SEED;
+    BENCHMARK("SidewinderMazeBits " + label) {
+        Constants::SidewinderMazeBits(bits, ++seed);
+        return bits.words[bits.wordsPerRow];
+    };
+    BENCHMARK("BinaryTreeMazeBits " + label) {
+        Constants::BinaryTreeMazeBits(bits, ++seed);
+        return bits.words[bits.wordsPerRow];
+    };
+}
+
+TEST_CASE("quadtree", "[quadtree]") {
+    const sf::FloatRect world { 0.0f, 0.0f, static_cast<float>(Constants::WORLD_WIDTH), static_cast<float>(Constants::WORLD_HEIGHT) };
+    for (size_t count : QUADTREE_SPRITES) {
+        std::mt19937 rng(BENCH_SEED);
+        std::uniform_real_distribution<float> x(world.left, world.left + world.width), y(world.top, world.top + world.height);
+        std::vector<std::unique_ptr<Sprite>> sprites;
+        for (size_t i = 0; i < count; ++i) sprites.push_back(std::make_unique<Sprite>(sf::Vector2f { x(rng), y(rng) }, Constants::SPRITE1_SCALE, Constants::SPRITE1_TEXTURE));
+
+        BENCHMARK("Quadtree insert " + std::to_string(count)) {
+            physics::Quadtree tree(world.left, world.top, world.width, world.height);
+            tree.subdivide();
+            for (auto& sprite : sprites) tree.insert(sprite);
+        };
+
+        physics::Quadtree tree(world.left, world.top, world.width, world.height);
+        tree.subdivide();
+        for (auto& sprite : sprites) tree.insert(sprite);
+        const sf::FloatRect area { world.left + world.width / 4, world.top + world.height / 4, world.width / 2, world.height / 2 };
+        BENCHMARK("Quadtree query " + std::to_string(count)) {
+            return tree.query(area).size();
+        };
+    }
+}
+
+TEST_CASE("collision", "[collision]") {
+    const sf::IntRect spriteRect = Constants::SPRITE1_ANIMATIONRECTS.at(0);
+    const sf::IntRect tileRect = Constants::TILES_SINGLE_RECTS.at(Constants::TILE_WALLINDEX);
+    const sf::Vector2f spriteSize(spriteRect.width, spriteRect.height), tileSize(tileRect.width, tileRect.height);
+    auto spriteMask = channelMask(Constants::SPRITE1_BITMASK.at(0), spriteRect.width, spriteRect.height);
+    auto tileMask = channelMask(Constants::TILES_BITMASKS.at(Constants::TILE_WALLINDEX), tileRect.width, tileRect.height);
+
+    // half overlapping, so the pixel loop runs over a quarter of each mask
+    const sf::Vector2f spritePosition { 0.0f, 0.0f }, tilePosition { spriteSize.x / 2, spriteSize.y / 2 };
+    BENCHMARK("pixelPerfectCollision") {
+        return physics::pixelPerfectCollision(spriteMask, spritePosition, spriteSize, tileMask, tilePosition, tileSize);
+    };
+    BENCHMARK("pixelPerfectCollision rotated") {
+        return physics::pixelPerfectCollision(spriteMask, spritePosition, spriteSize, tileMask, tilePosition, tileSize, 30.0f, 0.0f);
+    };
+
+    BENCHMARK("createBitmask sprite frame") {
+        return Constants::createBitmask(Constants::SPRITE1_TEXTURE, spriteRect);
+    };
+    BENCHMARK("createBitmask tile") {
+        return Constants::createBitmask(Constants::TILES_TEXTURE, tileRect);
+    };
+}
+
+TEST_CASE("tilemap", "[tilemap]") {
+    TileSet& set = tileSet();
+    BENCHMARK("TileMap constructor") {
+        return set.load();
+    };
+}
+
+TEST_CASE("tilemap edit journal", "[tilemap][edits]") {
+    std::unique_ptr<TileMap> tileMap = loadMaze(MAZE_SIZES[1]);
+    std::mt19937 rng(BENCH_SEED);
+    navigation::WalkGrid synced = navigation::WalkGrid::fromTileMap(*tileMap);
+    auto types = [&tileMap] {
+        std::vector<std::uint16_t> all(tileMap->getTileMapWidth() * tileMap->getTileMapHeight());
+        for (size_t i = 0; i < all.size(); ++i) all[i] = tileMap->getTileType(i);
+        return all;
+    };
+
+    // within the journal: the changes replay the old types into the new ones, and syncing patches to a full rebuild
+    std::vector<std::uint16_t> replayed = types();
+    std::uint64_t since = tileMap->getVersion();
+    for (int edit = 0; edit < 500; ++edit) randomEdit(*tileMap, rng);
+    std::vector<TileChange> changes;
+    REQUIRE(tileMap->changesSince(since, changes));
+    REQUIRE(changes.size() == 500);
+    for (const TileChange& change : changes) {
+        REQUIRE(change.oldType == replayed[change.index]);
+        replayed[change.index] = change.newType;
+    }
+    REQUIRE(replayed == types());
+    REQUIRE(synced.syncWith(*tileMap));
+    REQUIRE(synced.walkable == navigation::WalkGrid::fromTileMap(*tileMap).walkable);
+    REQUIRE(synced.mapVersion == tileMap->getVersion());
+    REQUIRE_FALSE(synced.syncWith(*tileMap));
+
+    // exactly a full ring still reaches back; one more change and the caller has to rebuild
+    since = tileMap->getVersion();
+    for (size_t edit = 0; edit < TILE_JOURNAL_CAPACITY; ++edit) randomEdit(*tileMap, rng);
+    changes.clear();
+    REQUIRE(tileMap->changesSince(since, changes));
+    REQUIRE(changes.size() == TILE_JOURNAL_CAPACITY);
+    randomEdit(*tileMap, rng);
+    REQUIRE_FALSE(tileMap->changesSince(since, changes));
+    REQUIRE(synced.syncWith(*tileMap)); // past the journal: rebuilt from the whole map
+    REQUIRE(synced.walkable == navigation::WalkGrid::fromTileMap(*tileMap).walkable);
+    REQUIRE(synced.mapVersion == tileMap->getVersion());
+
+    // a type the map was not made with is refused, and leaves no trace in the journal
+    const std::uint64_t before = tileMap->getVersion();
+    tileMap->setTile(1, 1, static_cast<std::uint16_t>(Constants::TILES_NUMBER));
+    REQUIRE(tileMap->getVersion() == before);
+}
+
+// what gamePlayScene::syncAutoPath asks before solving again: did an edit land on the route since it was solved
+TEST_CASE("auto path route edits", "[tilemap][edits]") {
+    std::unique_ptr<TileMap> tileMap = loadMaze(MAZE_SIZES[1]);
+    std::mt19937 rng(BENCH_SEED);
+    Constants::MazeGrid maze(tileMap->getTileMapWidth(), tileMap->getTileMapHeight());
+    for (size_t i = 0; i < maze.tiles.size(); ++i) maze.tiles[i] = tileMap->getTileType(i);
+    const Constants::MazeTileKinds kinds { Constants::TILE_STARTINGINDEX, Constants::TILE_ENDINGINDEX, Constants::TILE_WALKABLEINDEX, Constants::TILE_WALLINDEX };
+    std::vector<std::uint8_t> routeTiles(maze.tiles.size(), 0);
+    for (size_t tile : Constants::AstarPath(maze, kinds)) routeTiles[tile] = 1;
+    std::vector<TileChange> changes;
+
+    size_t onRoute = 0;
+    for (int edit = 0; edit < 2000; ++edit) {
+        const std::uint64_t since = tileMap->getVersion();
+        const unsigned x = 1 + rng() % (maze.width - 2), y = 1 + rng() % (maze.height - 2);
+        tileMap->setTile(x, y, Constants::TILE_WALKABLEINDEX);
+        const bool expected = routeTiles[y * maze.width + x];
+        onRoute += expected;
+        REQUIRE(navigation::routeTouchedSince(*tileMap, since, routeTiles, changes) == expected);
+    }
+    REQUIRE(onRoute > 0);
+    REQUIRE_FALSE(navigation::routeTouchedSince(*tileMap, tileMap->getVersion(), routeTiles, changes));
+
+    // past the journal nothing is known about the route, so it counts as touched
+    const std::uint64_t since = tileMap->getVersion();
+    const size_t offRoute = std::find(routeTiles.begin(), routeTiles.end(), 0) - routeTiles.begin();
+    for (size_t edit = 0; edit <= TILE_JOURNAL_CAPACITY; ++edit) tileMap->setTile(offRoute % maze.width, offRoute / maze.width, maze.tiles[offRoute]);
+    REQUIRE(navigation::routeTouchedSince(*tileMap, since, routeTiles, changes));
+}
+
+// one edit, published: older handles keep the old map, and the new snapshot copies only the chunk the edit was in
+TEST_CASE("tilemap snapshots", "[tilemap][edits]") {
+    std::unique_ptr<TileMap> tileMap = loadMaze(MAZE_SIZES[1]);
+    const MapSnapshotHandle before = tileMap->snapshot();
+    const navigation::WalkGrid walkableBefore = navigation::WalkGrid::fromTileMap(*tileMap);
+    REQUIRE(before->getChunkCount() > 1);
+
+    const unsigned x = MAP_CHUNK_SIZE + 3, y = 2 * MAP_CHUNK_SIZE + 5; // inside chunk (1, 2)
+    const std::uint16_t oldType = before->tileType(x, y);
+    const std::uint16_t newType = oldType == Constants::TILE_WALLINDEX ? Constants::TILE_WALKABLEINDEX : Constants::TILE_WALLINDEX;
+    tileMap->setTile(x, y, newType);
+    REQUIRE(tileMap->snapshot() == before); // nothing is published before publishSnapshot
+    tileMap->publishSnapshot();
+    const MapSnapshotHandle after = tileMap->snapshot();
+
+    REQUIRE(after != before);
+    REQUIRE(before->tileType(x, y) == oldType);
+    REQUIRE(after->tileType(x, y) == newType);
+    REQUIRE(after->getVersion() == tileMap->getVersion());
+    const size_t chunksWide = (before->getWidth() + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+    const size_t editedChunk = (y / MAP_CHUNK_SIZE) * chunksWide + x / MAP_CHUNK_SIZE;
+    for (size_t chunk = 0; chunk < after->getChunkCount(); ++chunk) {
+        if (chunk == editedChunk) REQUIRE(after->getChunk(chunk) != before->getChunk(chunk));
+        else REQUIRE(after->getChunk(chunk) == before->getChunk(chunk));
+    }
+
+    // what a worker builds from either handle is the map as it was at that version
+    REQUIRE(navigation::WalkGrid::fromSnapshot(*before).walkable == walkableBefore.walkable);
+    REQUIRE(navigation::WalkGrid::fromSnapshot(*after).walkable == navigation::WalkGrid::fromTileMap(*tileMap).walkable);
+}
+
+TEST_CASE("logging", "[logging]") {
+    size_t message = 0;
+    BENCHMARK("log_info") {
+        log_info("kernel bench message " + std::to_string(++message));
+    };
+}
+
+int main(int argc, char* argv[]) {
+    Catch::Session session;
+    std::string perfOut, perfBaseline;
+    double perfThreshold = perf::GATE_THRESHOLD;
+    using Catch::Clara::Opt;
+    session.cli(session.cli()
+        | Opt(perfOut, "file")["--perf-out"]("write every benchmark's median and MAD as JSON")
+        | Opt(perfBaseline, "file")["--perf-baseline"]("compare against this JSON baseline and fail on regressions")
+        | Opt(perfThreshold, "fraction")["--perf-threshold"]("slowdown that counts as a regression (default 0.10)"));
+    if (int status = session.applyCommandLine(argc, argv)) return status;
+
+    Constants::readFromYaml(std::filesystem::path("test/test-src/game/globals/config.yaml"));
+    Constants::MAZE_SEED = BENCH_SEED;
+    Constants::loadAssets();
+    Constants::makeRectsAndBitmasks();
+    Constants::generateTilePathInstruction(tileSet().mapPath, Constants::AstarPathInstructionGenerator);
+    MetaComponents::bigView.setSize(static_cast<float>(Constants::WORLD_WIDTH), static_cast<float>(Constants::WORLD_HEIGHT));
+
+    int result = session.run();
+    std::filesystem::remove(tileSet().mapPath);
+    if (result || (perfOut.empty() && perfBaseline.empty())) return result;
+
+    perf::Report current { perf::machineFingerprint(), perf::recordedKernels() };
+    if (!perfOut.empty() && !perf::writeReport(perfOut, current)) return 1;
+    if (perfBaseline.empty()) return 0;
+
+    // a gate without a usable baseline has nothing to hold the run to, so it fails rather than passing unchecked
+    perf::Report baseline;
+    if (!std::filesystem::exists(perfBaseline)) {
+        std::cout << "no baseline at " << perfBaseline << "; record one with `make bench_baseline`\n";
+        return 1;
+    }
+    if (!perf::readReport(perfBaseline, baseline)) {
+        std::cout << "could not read the baseline at " << perfBaseline << "\n";
+        return 1;
+    }
+    if (baseline.kernels.empty()) {
+        std::cout << "the baseline at " << perfBaseline << " records no kernels; record one with `make bench_baseline` on the reference machine\n";
+        return 1;
+    }
+    return perf::compareReports(baseline, current, perfThreshold, std::cout) ? 1 : 0;
+}
@@ -0,0 +1,52 @@
+//
+//  memoryBench.cpp
+//  sfml game template
+//
+//  Memory footprint of a maze by size: for each size the maze file is generated, its path instructions are found and the
+//  tilemap is loaded, the way the game scene does it, and the per-tag live and peak bytes are printed with the process RSS.
+//  Build and run with `make bench_memory` (MEMORY_SIZES="<size> ..." to change the sizes, e.g. MEMORY_SIZES=2001).
+//
+
+#include <array>
+#include <iostream>
+#include <filesystem>
+
+#include "game/globals/globals.hpp"
+#include "../test-assets/tiles/tiles.hpp"
+
+namespace {
+    constexpr size_t DEFAULT_MAZE_SIZES[] = { 201, 501, 1001 };
+
+    void printFootprint(size_t size) {
+        std::cout << "\n" << size << "x" << size << " maze\n" << memory::footprintReport() << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Constants::readFromYaml(std::filesystem::path("test/test-src/game/globals/config.yaml"));
+    Constants::loadAssets();
+    Constants::makeRectsAndBitmasks();
+
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) sizes.push_back(std::stoul(argv[i]) | 1); // generators need odd sizes
+    if (sizes.empty()) sizes.assign(std::begin(DEFAULT_MAZE_SIZES), std::end(DEFAULT_MAZE_SIZES));
+
+    std::array<std::shared_ptr<Tile>, Constants::TILES_NUMBER> tileTypes;
+    for (int i = 0; i < Constants::TILES_NUMBER; ++i) {
+        tileTypes.at(i) = std::make_shared<Tile>(Constants::TILES_SCALE, Constants::TILES_TEXTURE, Constants::TILES_SINGLE_RECTS[i], Constants::TILES_BITMASKS[i], Constants::TILES_BOOLS[i]);
+    }
+    std::cout << "before any maze\n" << memory::footprintReport() << "\n";
+
+    const std::filesystem::path mapPath = std::filesystem::temp_directory_path() / "memory_bench_tilemap.txt";
+    for (size_t size : sizes) {
+        Constants::TILEMAP_WIDTH = Constants::TILEMAP_HEIGHT = size;
+        std::vector<size_t>().swap(Constants::TILEPATH_INSTRUCTION); // so the last size's reservation is not counted again
+        memory::resetPeaks();
+
+        Constants::writeRandomTileMap(mapPath, Constants::DFSmazeGenerator);
+        Constants::generateTilePathInstruction(mapPath, Constants::AstarPathInstructionGenerator);
+        auto tileMap = std::make_unique<TileMap>(tileTypes.data(), Constants::TILES_NUMBER, size, size, Constants::TILE_WIDTH, Constants::TILE_HEIGHT, mapPath, Constants::TILEMAP_POSITION);
+        printFootprint(size);
+    }
+    std::filesystem::remove(mapPath);
+}
@@ -0,0 +1,513 @@
+//
+//  navBench.cpp
+//  sfml game template
+//
+//  Headless end-to-end benchmark of the auto-navigator: generate (or load) a maze, solve it with A*, then tick the
+//  navigator at the game's tick rate with no window and no frame limit until the goal tile is reached. Sweeps maze
+//  sizes and generators over a few seeds and prints ticks/sec, simulated and wall time to solve, and a per-subsystem
+//  breakdown, then times batched path queries for many agents, walks any-angle routes with followWaypoints counting heading
+//  changes, and checks the flow field's incremental target moves against fresh builds. Build and run with `make bench_nav`, or
+//  `make bench_nav NAV_ARGS="--maze path/to/tilemap.txt"`.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+#include "game/globals/globals.hpp"
+#include "game/physics/physics.hpp"
+#include "game/navigation/batchPaths.hpp"
+#include "game/navigation/anyAngle.hpp"
+#include "game/navigation/corridorGraph.hpp"
+#include "game/navigation/flowField.hpp"
+
+namespace {
+    constexpr std::uint32_t SEEDS[] = { 1, 2, 3 };
+    constexpr size_t MAZE_SIZES[][2] = { { 19, 13 }, { 51, 51 }, { 101, 101 }, { 201, 201 }, { 401, 401 } };
+    constexpr size_t MAX_TICKS_PER_TILE = 1000; // gives up on a run that stops making progress
+    constexpr size_t BATCH_QUERIES = 256; // path requests per simulated frame of AI agents
+    constexpr size_t BATCH_GOALS = 8;
+    constexpr int BATCH_REPEATS = 10;
+    constexpr std::uint32_t OPEN_WALL_PERCENT = 40; // interior walls knocked out to turn a maze into an open map
+    constexpr float TURN_DEGREES = 1.0f; // smaller heading changes while following waypoints are rounding, not turns
+    constexpr size_t FLOW_TARGET_STEPS = 2000; // target moves checked against a fresh field, at most
+    constexpr size_t FLOW_AGENTS = 256; // pursuers stepped along the field after every target move
+
+    using GridGenerator = void (*)(Constants::MazeGrid&, const Constants::MazeTileKinds&, std::mt19937&);
+
+    struct RunResult {
+        bool solved = false;
+        size_t pathLength = 0;
+        size_t ticks = 0;
+        double generateMs = 0.0;
+        double pathMs = 0.0;
+        double navigateMs = 0.0; // navigator ticks including the per-tick goal test
+        size_t segments = 0; // the same route as straight runs
+        size_t segmentTicks = 0; // more than ticks: the tile navigator jumps half a tile at every snap
+        double segmentMs = 0.0; // following the runs instead of the tiles
+    };
+
+    struct SweepTotals {
+        RunResult sum;
+        size_t runs = 0;
+        size_t failures = 0;
+
+        void add(const RunResult& run) {
+            ++runs;
+            if (!run.solved) { ++failures; return; }
+            sum.pathLength += run.pathLength;
+            sum.ticks += run.ticks;
+            sum.generateMs += run.generateMs;
+            sum.pathMs += run.pathMs;
+            sum.navigateMs += run.navigateMs;
+            sum.segments += run.segments;
+            sum.segmentTicks += run.segmentTicks;
+            sum.segmentMs += run.segmentMs;
+        }
+    };
+
+    Constants::MazeTileKinds tileKinds() {
+        return { Constants::TILE_STARTINGINDEX, Constants::TILE_ENDINGINDEX, Constants::TILE_WALKABLEINDEX, Constants::TILE_WALLINDEX };
+    }
+
+    // A* and then the navigator from spawn to goal; generation or loading is timed by the caller
+    RunResult solveMaze(const Constants::MazeGrid& grid) {
+        RunResult result;
+        const Constants::MazeTileKinds kinds = tileKinds();
+
+        Timer pathTimer;
+        std::vector<size_t> path = Constants::AstarPath(grid, kinds);
+        result.pathMs = pathTimer.ElapsedMillis();
+        if (path.empty()) return result;
+        result.pathLength = path.size();
+
+        const size_t spawnIndex = path.back();
+        const size_t goalIndex = path.front();
+        std::vector<physics::PathSegment> segments = physics::compressPath(path, grid.width);
+        result.segments = segments.size();
+        physics::NavigationGrid navGrid { Constants::TILEMAP_POSITION, static_cast<float>(Constants::TILE_WIDTH), static_cast<float>(Constants::TILE_HEIGHT), grid.width };
+        const sf::Vector2f spawnCentre { navGrid.origin.x + (spawnIndex % grid.width + 0.5f) * navGrid.tileWidth,
+                                         navGrid.origin.y + (spawnIndex / grid.width + 0.5f) * navGrid.tileHeight };
+        auto reachedGoal = [&](const physics::NavigationPose& pose) {
+            size_t tileX = static_cast<size_t>((pose.position.x - navGrid.origin.x) / navGrid.tileWidth);
+            size_t tileY = static_cast<size_t>((pose.position.y - navGrid.origin.y) / navGrid.tileHeight);
+            return tileX < grid.width && tileY * grid.width + tileX == goalIndex;
+        };
+        physics::NavigationPose pose { spawnCentre, 0.0f };
+        path.pop_back(); // start centred on the spawn tile, facing the first step, as if the navigator had just snapped there
+        if (!path.empty()) {
+            const size_t firstStep = path.back();
+            path.pop_back();
+            if (firstStep == spawnIndex + 1) pose.headingAngle = 0.0f;
+            else if (firstStep + grid.width == spawnIndex) pose.headingAngle = 270.0f;
+            else if (firstStep + 1 == spawnIndex) pose.headingAngle = 180.0f;
+            else pose.headingAngle = 90.0f;
+        }
+
+        const float deltaTime = 1.0f / Constants::TICK_RATE;
+        const size_t tickLimit = result.pathLength * MAX_TICKS_PER_TILE;
+        Timer navigateTimer;
+        while (result.ticks < tickLimit) {
+            physics::navigateMaze(pose, Constants::SPRITE1_SPEED, deltaTime, navGrid, path);
+            ++result.ticks;
+            if (reachedGoal(pose)) { result.solved = true; break; }
+        }
+        result.navigateMs = navigateTimer.ElapsedMillis();
+
+        // the same route following straight segments
+        physics::NavigationPose segmentPose { spawnCentre, segments.empty() ? 0.0f : segments.back().headingAngle };
+        bool segmentSolved = false;
+        Timer segmentTimer;
+        while (result.segmentTicks < tickLimit) {
+            physics::followPathSegments(segmentPose, Constants::SPRITE1_SPEED, deltaTime, navGrid, segments);
+            ++result.segmentTicks;
+            if (reachedGoal(segmentPose)) { segmentSolved = true; break; }
+        }
+        result.segmentMs = segmentTimer.ElapsedMillis();
+        result.solved = result.solved && segmentSolved;
+        return result;
+    }
+
+    void printHeader() {
+        std::cout << std::left << std::setw(10) << "generator" << std::setw(10) << "size" << std::right
+                  << std::setw(8) << "path" << std::setw(8) << "runs" << std::setw(10) << "ticks" << std::setw(10) << "sim s"
+                  << std::setw(10) << "gen ms" << std::setw(10) << "A* ms" << std::setw(10) << "nav ms" << std::setw(10) << "seg ticks" << std::setw(10) << "seg ms"
+                  << std::setw(12) << "solve ms" << std::setw(14) << "ticks/s" << std::setw(14) << "seg ticks/s" << '\n';
+    }
+
+    void printRow(const std::string& generator, const std::string& size, const SweepTotals& totals) {
+        const size_t solvedRuns = totals.runs - totals.failures;
+        std::cout << std::left << std::setw(10) << generator << std::setw(10) << size << std::right;
+        if (!solvedRuns) {
+            std::cout << "  no run reached the goal\n";
+            return;
+        }
+
+        const RunResult& sum = totals.sum;
+        const double runs = static_cast<double>(solvedRuns);
+        const double solveMs = sum.generateMs + sum.pathMs + sum.navigateMs;
+        std::cout << std::fixed
+                  << std::setw(8) << sum.pathLength / solvedRuns << std::setw(8) << sum.segments / solvedRuns << std::setw(10) << sum.ticks / solvedRuns
+                  << std::setprecision(1) << std::setw(10) << sum.ticks / runs / Constants::TICK_RATE
+                  << std::setprecision(3) << std::setw(10) << sum.generateMs / runs << std::setw(10) << sum.pathMs / runs
+                  << std::setw(10) << sum.navigateMs / runs << std::setw(10) << sum.segmentTicks / solvedRuns << std::setw(10) << sum.segmentMs / runs
+                  << std::setw(12) << solveMs / runs
+                  << std::setprecision(0) << std::setw(14) << (sum.navigateMs > 0.0 ? sum.ticks / (sum.navigateMs / 1000.0) : 0.0)
+                  << std::setw(14) << (sum.segmentMs > 0.0 ? sum.segmentTicks / (sum.segmentMs / 1000.0) : 0.0);
+        if (totals.failures) std::cout << "  (" << totals.failures << " unsolved)";
+        std::cout << '\n';
+    }
+
+    // batched queries on the largest maze: agents with scattered starts heading for a handful of goals
+    void benchBatchQueries(GridGenerator generator, const char* name) {
+        const size_t size = MAZE_SIZES[std::size(MAZE_SIZES) - 1][0];
+        Constants::MazeGrid grid(size, size);
+        std::mt19937 rng(SEEDS[0]);
+        generator(grid, tileKinds(), rng);
+        navigation::WalkGrid walkGrid = navigation::WalkGrid::fromMaze(grid, tileKinds());
+
+        std::vector<size_t> walkable;
+        for (size_t i = 0; i < walkGrid.size(); ++i) if (walkGrid.walkable[i]) walkable.push_back(i);
+        std::vector<navigation::PathQuery> queries(BATCH_QUERIES);
+        for (size_t i = 0; i < BATCH_QUERIES; ++i) {
+            queries[i].start = walkable[rng() % walkable.size()];
+            queries[i].goal = walkable[(i % BATCH_GOALS) * walkable.size() / BATCH_GOALS];
+        }
+
+        navigation::PathBatch batch;
+        navigation::findPaths(walkGrid, queries, batch); // warm up the workspaces
+        float bestMs = 1e9f;
+        for (int repeat = 0; repeat < BATCH_REPEATS; ++repeat) {
+            Timer batchTimer;
+            navigation::findPaths(walkGrid, queries, batch);
+            bestMs = std::min(bestMs, batchTimer.ElapsedMillis());
+        }
+
+        navigation::CorridorGraph graph = navigation::CorridorGraph::build(walkGrid);
+        navigation::PathBatch graphBatch;
+        navigation::findPaths(graph, queries, graphBatch);
+        float graphMs = 1e9f;
+        for (int repeat = 0; repeat < BATCH_REPEATS; ++repeat) {
+            Timer batchTimer;
+            navigation::findPaths(graph, queries, graphBatch);
+            graphMs = std::min(graphMs, batchTimer.ElapsedMillis());
+        }
+
+        // the same agents asking again on an unchanged map: every query is a cache hit
+        navigation::PathCache cache(BATCH_QUERIES);
+        navigation::findPaths(graph, queries, graphBatch, cache, 0);
+        float cachedMs = 1e9f;
+        for (int repeat = 0; repeat < BATCH_REPEATS; ++repeat) {
+            Timer batchTimer;
+            navigation::findPaths(graph, queries, graphBatch, cache, 0);
+            cachedMs = std::min(cachedMs, batchTimer.ElapsedMillis());
+        }
+        navigation::PathCache gridCache(BATCH_QUERIES);
+        navigation::PathBatch gridCachedBatch;
+        navigation::findPaths(walkGrid, queries, gridCachedBatch, gridCache, 0);
+        float gridCachedMs = 1e9f;
+        for (int repeat = 0; repeat < BATCH_REPEATS; ++repeat) {
+            Timer batchTimer;
+            navigation::findPaths(walkGrid, queries, gridCachedBatch, gridCache, 0);
+            gridCachedMs = std::min(gridCachedMs, batchTimer.ElapsedMillis());
+        }
+        bool cachedSame = gridCachedBatch.offsets == batch.offsets;
+
+        std::cout << std::left << std::setw(10) << name << std::setw(10) << (std::to_string(size) + "x" + std::to_string(size)) << std::right
+                  << std::setw(8) << BATCH_QUERIES << " queries, " << BATCH_GOALS << " goals, " << batch.tiles.size() << " path tiles: "
+                  << std::setprecision(3) << bestMs << " ms per batch, " << std::setprecision(2) << bestMs * 1000.0f / BATCH_QUERIES << " us per query; "
+                  << std::setprecision(3) << graphMs << " ms on the corridor graph, " << cachedMs << " ms repeated through the path cache ("
+                  << gridCachedMs << " ms on the grid)"
+                  << (graphBatch.tiles.size() == batch.tiles.size() && cachedSame ? "" : " (lengths differ)") << '\n';
+    }
+
+    // the maze's own start-to-goal search: tile A* against building the corridor graph and searching that
+    bool benchCorridorGraph(GridGenerator generator, const char* name, const size_t* size) {
+        Constants::MazeGrid grid(size[0], size[1]);
+        std::mt19937 rng(SEEDS[0]);
+        generator(grid, tileKinds(), rng);
+
+        Timer pathTimer;
+        std::vector<size_t> tilePath = Constants::AstarPath(grid, tileKinds());
+        double pathMs = pathTimer.ElapsedMillis();
+
+        Timer buildTimer;
+        navigation::CorridorGraph graph = navigation::CorridorGraph::build(navigation::WalkGrid::fromMaze(grid, tileKinds()));
+        double buildMs = buildTimer.ElapsedMillis();
+        Timer queryTimer;
+        std::vector<size_t> graphPath = tilePath.empty() ? std::vector<size_t>() : graph.findPath(tilePath.back(), tilePath.front());
+        double queryMs = queryTimer.ElapsedMillis();
+
+        std::cout << std::left << std::setw(10) << name << std::setw(10) << (std::to_string(size[0]) + "x" + std::to_string(size[1])) << std::right
+                  << std::setw(10) << graph.tileCount() << std::setw(10) << graph.nodeCount() << std::setw(10) << graph.coreNodeCount()
+                  << std::setw(12) << std::fixed << std::setprecision(3) << pathMs << std::setw(12) << buildMs << std::setw(12) << queryMs;
+        bool same = graphPath.size() == tilePath.size();
+        if (!same) std::cout << "  (path " << graphPath.size() << " tiles, A* " << tilePath.size() << ")";
+        std::cout << '\n';
+        return same;
+    }
+
+    struct FollowResult {
+        bool arrived = false;
+        size_t ticks = 0;
+        size_t turns = 0; // ticks where the heading changed by more than TURN_DEGREES
+        double ms = 0.0;
+    };
+
+    // an agent walked from the first waypoint to the goal with followWaypoints at the game's tick rate
+    FollowResult followRoute(std::vector<size_t> waypoints, const physics::NavigationGrid& geometry, float pathLength) {
+        FollowResult result;
+        const size_t goal = waypoints.front();
+        physics::NavigationPose pose { navigation::tileCenter(waypoints.back(), geometry), 0.0f };
+        const float deltaTime = 1.0f / Constants::TICK_RATE;
+        const size_t tickLimit = static_cast<size_t>(pathLength + 1.0f) * MAX_TICKS_PER_TILE;
+        bool moving = true;
+        Timer followTimer;
+        while (moving && result.ticks < tickLimit) {
+            const float heading = pose.headingAngle;
+            moving = navigation::followWaypoints(pose, Constants::SPRITE1_SPEED, deltaTime, geometry, waypoints);
+            if (!result.ticks++) continue;
+            const float turn = std::abs(pose.headingAngle - heading);
+            if (std::min(turn, 360.0f - turn) > TURN_DEGREES) ++result.turns;
+        }
+        result.ms = followTimer.ElapsedMillis();
+        const sf::Vector2f miss = pose.position - navigation::tileCenter(goal, geometry);
+        result.arrived = !moving && std::abs(miss.x) < 0.01f && std::abs(miss.y) < 0.01f;
+        return result;
+    }
+
+    /* any-angle paths on the largest maze with walls knocked out: tile path vs string-pulled vs Theta*, lengths in tiles, then
+    each walked with followWaypoints; false if an agent does not end on the goal tile's centre */
+    bool benchAnyAngle(GridGenerator generator, const char* name) {
+        const size_t size = MAZE_SIZES[std::size(MAZE_SIZES) - 1][0];
+        Constants::MazeGrid grid(size, size);
+        std::mt19937 rng(SEEDS[0]);
+        generator(grid, tileKinds(), rng);
+        for (size_t y = 1; y + 1 < grid.height; ++y) {
+            for (size_t x = 1; x + 1 < grid.width; ++x) {
+                if (grid.at(x, y) == tileKinds().wall && rng() % 100 < OPEN_WALL_PERCENT) grid.at(x, y) = tileKinds().walkable;
+            }
+        }
+        navigation::WalkGrid walkGrid = navigation::WalkGrid::fromMaze(grid, tileKinds());
+
+        Timer pathTimer;
+        std::vector<size_t> tilePath = Constants::AstarPath(grid, tileKinds());
+        double pathMs = pathTimer.ElapsedMillis();
+        if (tilePath.empty()) {
+            std::cout << std::left << std::setw(10) << name << "no path\n";
+            return false;
+        }
+
+        Timer smoothTimer;
+        std::vector<size_t> pulled = navigation::smoothPath(walkGrid, tilePath);
+        double smoothMs = smoothTimer.ElapsedMillis();
+        Timer thetaTimer;
+        std::vector<size_t> theta = navigation::thetaStar(walkGrid, tilePath.back(), tilePath.front());
+        double thetaMs = thetaTimer.ElapsedMillis();
+
+        const physics::NavigationGrid geometry { Constants::TILEMAP_POSITION, static_cast<float>(Constants::TILE_WIDTH), static_cast<float>(Constants::TILE_HEIGHT), grid.width };
+        bool allArrived = true;
+        auto print = [&](const char* method, const std::vector<size_t>& waypoints, double ms) {
+            const float length = navigation::waypointPathLength(waypoints, grid.width);
+            const FollowResult follow = waypoints.empty() ? FollowResult() : followRoute(waypoints, geometry, length);
+            std::cout << std::left << std::setw(10) << name << std::setw(14) << method << std::right << std::setw(10) << waypoints.size()
+                      << std::setw(12) << std::fixed << std::setprecision(1) << length
+                      << std::setw(12) << std::setprecision(2) << ms << std::setw(10) << follow.ticks << std::setw(10) << follow.turns
+                      << std::setw(12) << std::setprecision(3) << follow.ms << std::defaultfloat;
+            if (!follow.arrived) std::cout << "  (did not arrive)";
+            std::cout << '\n';
+            allArrived = allArrived && follow.arrived;
+        };
+        print("A* tiles", tilePath, pathMs);
+        print("A*+pulling", pulled, pathMs + smoothMs);
+        print("Theta*", theta, thetaMs);
+        return allArrived;
+    }
+
+    // tiles to the target along the field from every tile; SIZE_MAX where it never gets there (unreachable, or a cycle)
+    std::vector<size_t> fieldRouteLengths(const navigation::FlowField& field) {
+        constexpr size_t unknown = SIZE_MAX - 1, never = SIZE_MAX;
+        std::vector<size_t> length(field.tileCount(), unknown);
+        std::vector<std::uint8_t> onChain(field.tileCount(), 0);
+        std::vector<size_t> chain;
+        for (size_t start = 0; start < length.size(); ++start) {
+            chain.clear();
+            size_t tile = start;
+            while (length[tile] == unknown && !onChain[tile]) {
+                if (tile == field.getTarget()) { length[tile] = 0; break; }
+                if (field.direction(tile) == navigation::Direction::None) { length[tile] = never; break; }
+                onChain[tile] = 1;
+                chain.push_back(tile);
+                tile = field.nextTile(tile);
+            }
+            size_t value = onChain[tile] ? never : length[tile];
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+                if (value != never) ++value;
+                length[*it] = value;
+                onChain[*it] = 0;
+            }
+        }
+        return length;
+    }
+
+    /* a target walking the maze's own route, the field following it with moveTarget, checked after every step against a field
+    built from scratch: on a perfect maze the directions must be identical, on an open map every tile must still arrive, at most
+    two tiles longer per move since the last rebuild. Pursuers step along the field meanwhile and must stay on walkable tiles */
+    bool benchFlowField(GridGenerator generator, const char* name, bool openMap) {
+        const size_t* size = MAZE_SIZES[3];
+        Constants::MazeGrid grid(size[0], size[1]);
+        std::mt19937 rng(SEEDS[0]);
+        generator(grid, tileKinds(), rng);
+        if (openMap) {
+            for (size_t y = 1; y + 1 < grid.height; ++y) {
+                for (size_t x = 1; x + 1 < grid.width; ++x) {
+                    if (grid.at(x, y) == tileKinds().wall && rng() % 100 < OPEN_WALL_PERCENT) grid.at(x, y) = tileKinds().walkable;
+                }
+            }
+        }
+        navigation::WalkGrid walkGrid = navigation::WalkGrid::fromMaze(grid, tileKinds());
+        std::vector<size_t> route = Constants::AstarPath(grid, tileKinds()); // goal first
+        if (route.size() < 2) {
+            std::cout << std::left << std::setw(10) << name << "no path\n";
+            return false;
+        }
+
+        physics::NavigationGrid geometry { Constants::TILEMAP_POSITION, static_cast<float>(Constants::TILE_WIDTH), static_cast<float>(Constants::TILE_HEIGHT), grid.width };
+        std::vector<size_t> walkable;
+        for (size_t i = 0; i < walkGrid.size(); ++i) if (walkGrid.walkable[i]) walkable.push_back(i);
+        std::vector<physics::NavigationPose> agents(FLOW_AGENTS);
+        for (auto& agent : agents) agent.position = navigation::tileCenter(walkable[rng() % walkable.size()], geometry);
+
+        navigation::FlowField field, fresh;
+        field.build(walkGrid, route.back());
+        const size_t steps = std::min(route.size() - 1, FLOW_TARGET_STEPS);
+        const float deltaTime = 1.0f / Constants::TICK_RATE;
+        size_t inPlace = 0, badSteps = 0, offGrid = 0;
+        double moveNs = 0.0, buildNs = 0.0, agentNs = 0.0; // Timer counts whole microseconds, an in-place move takes a few ns
+        using Clock = std::chrono::steady_clock;
+        auto nanosecondsSince = [](Clock::time_point start) { return std::chrono::duration<double, std::nano>(Clock::now() - start).count(); };
+        for (size_t step = 1; step <= steps; ++step) {
+            const size_t target = route[route.size() - 1 - step];
+            Clock::time_point start = Clock::now();
+            inPlace += field.moveTarget(target);
+            moveNs += nanosecondsSince(start);
+            start = Clock::now();
+            fresh.build(walkGrid, target);
+            buildNs += nanosecondsSince(start);
+
+            bool same = true;
+            if (!openMap) {
+                for (size_t i = 0; i < fresh.tileCount() && same; ++i) same = field.direction(i) == fresh.direction(i);
+            } else {
+                const std::vector<size_t> lengths = fieldRouteLengths(field), freshLengths = fieldRouteLengths(fresh);
+                for (size_t i = 0; i < lengths.size() && same; ++i) {
+                    same = (lengths[i] == SIZE_MAX) == (freshLengths[i] == SIZE_MAX)
+                           && (lengths[i] == SIZE_MAX || lengths[i] <= freshLengths[i] + 2 * navigation::FLOW_REBUILD_INTERVAL);
+                }
+            }
+            badSteps += !same;
+
+            start = Clock::now();
+            for (auto& agent : agents) navigation::followFlowField(agent, Constants::SPRITE1_SPEED, deltaTime, geometry, field);
+            agentNs += nanosecondsSince(start);
+            for (const auto& agent : agents) offGrid += !walkGrid.isWalkable(navigation::tileIndexAt(agent.position, geometry, walkGrid.size()));
+        }
+
+        std::cout << std::left << std::setw(10) << name << std::setw(10) << (std::to_string(size[0]) + "x" + std::to_string(size[1])) << std::setw(8) << (openMap ? "open" : "maze")
+                  << std::right << std::setw(8) << steps << std::setw(10) << inPlace << std::setw(10) << field.getBuildCount()
+                  << std::fixed << std::setprecision(1) << std::setw(12) << moveNs / steps << std::setw(12) << buildNs / 1000.0 / steps
+                  << std::setprecision(1) << std::setw(14) << agentNs / (static_cast<double>(steps) * FLOW_AGENTS) << std::setw(8) << badSteps << std::defaultfloat;
+        if (offGrid) std::cout << "  (" << offGrid << " agent ticks off walkable tiles)";
+        std::cout << '\n';
+        return badSteps == 0 && offGrid == 0;
+    }
+
+    int benchLoadedMaze(const std::filesystem::path& mazePath) {
+        std::ifstream file(mazePath);
+        if (!file.is_open()) {
+            std::cerr << "Could not open maze " << mazePath << '\n';
+            return 1;
+        }
+
+        Timer loadTimer;
+        Constants::MazeGrid grid(Constants::TILEMAP_WIDTH, Constants::TILEMAP_HEIGHT);
+        if (!Constants::readMazeGrid(file, grid)) {
+            std::cerr << "Maze " << mazePath << " is not a " << grid.width << "x" << grid.height << " tilemap (tilemap.width/height in the config)\n";
+            return 1;
+        }
+        double loadMs = loadTimer.ElapsedMillis();
+
+        SweepTotals totals;
+        RunResult run = solveMaze(grid);
+        run.generateMs = loadMs; // reported in the generation column
+        totals.add(run);
+
+        printHeader();
+        printRow("loaded", std::to_string(grid.width) + "x" + std::to_string(grid.height), totals);
+        return run.solved ? 0 : 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Constants::readFromYaml(std::filesystem::path("test/test-src/game/globals/config.yaml"));
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::string(argv[i]) == "--maze") return benchLoadedMaze(argv[i + 1]);
+    }
+
+    const std::pair<const char*, GridGenerator> generators[] = { { "DFS", Constants::DFSmazeGrid }, { "Prim", Constants::PrimsMazeGrid } };
+
+    std::cout << "auto-navigator at " << Constants::TICK_RATE << " ticks/s simulated, speed " << Constants::SPRITE1_SPEED
+              << ", mean of " << std::size(SEEDS) << " seeds\n";
+    printHeader();
+
+    bool allSolved = true;
+    for (const auto& [name, generator] : generators) {
+        for (const auto& size : MAZE_SIZES) {
+            SweepTotals totals;
+            for (std::uint32_t seed : SEEDS) {
+                Constants::MazeGrid grid(size[0], size[1]);
+                std::mt19937 rng(seed);
+
+                Timer generateTimer;
+                generator(grid, tileKinds(), rng);
+                double generateMs = generateTimer.ElapsedMillis();
+
+                RunResult run = solveMaze(grid);
+                run.generateMs = generateMs;
+                totals.add(run);
+            }
+            allSolved = allSolved && !totals.failures;
+            printRow(name, std::to_string(size[0]) + "x" + std::to_string(size[1]), totals);
+        }
+    }
+
+    std::cout << "\ncorridor graph\n" << std::left << std::setw(10) << "maze" << std::setw(10) << "size" << std::right << std::setw(10) << "tiles"
+              << std::setw(10) << "nodes" << std::setw(10) << "core" << std::setw(12) << "A* ms" << std::setw(12) << "build ms" << std::setw(12) << "query ms" << '\n';
+    for (const auto& [name, generator] : generators) {
+        for (const auto& size : MAZE_SIZES) allSolved = benchCorridorGraph(generator, name, size) && allSolved;
+    }
+
+    const unsigned threads = jobs::engineJobs().threadCount(); // started before printing, it logs as it starts
+    std::cout << "\nbatched path queries on " << threads << " threads, best of " << BATCH_REPEATS << '\n';
+    for (const auto& [name, generator] : generators) benchBatchQueries(generator, name);
+
+    std::cout << "\nany-angle paths with " << OPEN_WALL_PERCENT << "% of walls removed\n" << std::left << std::setw(10) << "maze" << std::setw(14) << "method"
+              << std::right << std::setw(10) << "waypoints" << std::setw(12) << "length" << std::setw(12) << "ms"
+              << std::setw(10) << "ticks" << std::setw(10) << "turns" << std::setw(12) << "follow ms" << '\n';
+    for (const auto& [name, generator] : generators) allSolved = benchAnyAngle(generator, name) && allSolved;
+
+    std::cout << "\nflow field following a moving target, checked against a fresh build every step, " << FLOW_AGENTS << " pursuers\n"
+              << std::left << std::setw(10) << "maze" << std::setw(10) << "size" << std::setw(8) << "map" << std::right << std::setw(8) << "steps"
+              << std::setw(10) << "in place" << std::setw(10) << "builds" << std::setw(12) << "move ns" << std::setw(12) << "build us"
+              << std::setw(14) << "agent ns/tick" << std::setw(8) << "wrong" << '\n';
+    for (const auto& [name, generator] : generators) {
+        allSolved = benchFlowField(generator, name, false) && allSolved;
+        allSolved = benchFlowField(generator, name, true) && allSolved;
+    }
+    return allSolved ? 0 : 1;
+}
@@ -0,0 +1,200 @@
+//
+//  perfGate.cpp
+//  sfml game template
+//
+
+#include "perfGate.hpp"
+
+#include <cmath>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <sys/utsname.h>
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+#include <yaml-cpp/yaml.h>
+#include <catch2/reporters/catch_reporter_event_listener.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "../test-logging/log.hpp"
+
+namespace perf {
+
+    namespace {
+        std::vector<KernelResult> kernels;
+
+        double median(std::vector<double>& values) { // reorders values
+            if (values.empty()) return 0.0;
+            const size_t middle = values.size() / 2;
+            std::nth_element(values.begin(), values.begin() + middle, values.end());
+            double upper = values[middle];
+            if (values.size() % 2) return upper;
+            return (*std::max_element(values.begin(), values.begin() + middle) + upper) / 2.0;
+        }
+
+        // standard error of a median from its MAD: sigma ~ 1.4826 MAD for normal noise, and a median's error is ~1.2533 sigma / sqrt(n)
+        double medianError(const KernelResult& kernel) {
+            return kernel.samples ? 1.4826 * 1.2533 * kernel.madNs / std::sqrt(static_cast<double>(kernel.samples)) : 0.0;
+        }
+
+        std::string jsonString(const std::string& text) {
+            std::string quoted = "\"";
+            for (char c : text) {
+                if (c == '"' || c == '\\') quoted += '\\';
+                quoted += c;
+            }
+            return quoted + "\"";
+        }
+
+        std::string cpuName() {
+#if defined(__APPLE__)
+            char brand[256] = {};
+            size_t size = sizeof(brand);
+            if (sysctlbyname("machdep.cpu.brand_string", brand, &size, nullptr, 0) == 0) return brand;
+#else
+            std::ifstream cpuInfo("/proc/cpuinfo");
+            std::string line;
+            while (std::getline(cpuInfo, line)) {
+                if (line.rfind("model name", 0) != 0) continue;
+                size_t colon = line.find(':');
+                if (colon != std::string::npos) return line.substr(line.find_first_not_of(' ', colon + 1));
+            }
+#endif
+            return "unknown";
+        }
+
+        // keeps the raw samples of every benchmark that runs; Catch2 itself only reports means
+        class PerfListener : public Catch::EventListenerBase {
+        public:
+            using Catch::EventListenerBase::EventListenerBase;
+
+            void benchmarkEnded(const Catch::BenchmarkStats<>& stats) override {
+                std::vector<double> samplesNs;
+                samplesNs.reserve(stats.samples.size());
+                for (const auto& sample : stats.samples) samplesNs.push_back(std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(sample).count());
+                kernels.push_back(summarize(stats.info.name, std::move(samplesNs), stats.info.iterations));
+            }
+        };
+    }
+
+    Fingerprint machineFingerprint() {
+        Fingerprint fingerprint;
+        utsname name {};
+        if (uname(&name) == 0) fingerprint.system = std::string(name.sysname) + " " + name.release + " " + name.machine;
+        fingerprint.cpu = cpuName();
+#if defined(__clang__)
+        fingerprint.compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+        fingerprint.compiler = "gcc " __VERSION__;
+#else
+        fingerprint.compiler = "unknown";
+#endif
+        fingerprint.threads = std::thread::hardware_concurrency();
+        return fingerprint;
+    }
+
+    KernelResult summarize(const std::string& name, std::vector<double> samplesNs, int iterations) {
+        KernelResult kernel;
+        kernel.name = name;
+        kernel.iterations = iterations;
+        kernel.samples = static_cast<unsigned>(samplesNs.size());
+        kernel.medianNs = median(samplesNs);
+        for (double& sample : samplesNs) sample = std::abs(sample - kernel.medianNs);
+        kernel.madNs = median(samplesNs);
+        return kernel;
+    }
+
+    const std::vector<KernelResult>& recordedKernels() { return kernels; }
+
+    bool writeReport(const std::filesystem::path& path, const Report& report) {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            log_error("Could not write benchmark results to " + path.string());
+            return false;
+        }
+
+        const Fingerprint& machine = report.fingerprint;
+        file << "{\n  \"fingerprint\": {\n"
+             << "    \"system\": " << jsonString(machine.system) << ",\n"
+             << "    \"cpu\": " << jsonString(machine.cpu) << ",\n"
+             << "    \"compiler\": " << jsonString(machine.compiler) << ",\n"
+             << "    \"threads\": " << machine.threads << "\n  },\n  \"kernels\": [";
+        file << std::setprecision(6) << std::fixed;
+        for (size_t i = 0; i < report.kernels.size(); ++i) {
+            const KernelResult& kernel = report.kernels[i];
+            file << (i ? ",\n" : "\n") << "    { \"name\": " << jsonString(kernel.name) << ", \"median_ns\": " << kernel.medianNs << ", \"mad_ns\": " << kernel.madNs
+                 << ", \"iterations\": " << kernel.iterations << ", \"samples\": " << kernel.samples << " }";
+        }
+        file << "\n  ]\n}\n";
+        return file.good();
+    }
+
+    bool readReport(const std::filesystem::path& path, Report& report) {
+        try {
+            YAML::Node root = YAML::LoadFile(path.string()); // JSON is valid YAML
+            const YAML::Node machine = root["fingerprint"];
+            report.fingerprint.system = machine["system"].as<std::string>("");
+            report.fingerprint.cpu = machine["cpu"].as<std::string>("");
+            report.fingerprint.compiler = machine["compiler"].as<std::string>("");
+            report.fingerprint.threads = machine["threads"].as<unsigned>(0);
+
+            report.kernels.clear();
+            for (const YAML::Node& entry : root["kernels"]) {
+                KernelResult kernel;
+                kernel.name = entry["name"].as<std::string>();
+                kernel.medianNs = entry["median_ns"].as<double>();
+                kernel.madNs = entry["mad_ns"].as<double>(0.0);
+                kernel.iterations = entry["iterations"].as<int>(0);
+                kernel.samples = entry["samples"].as<unsigned>(0);
+                report.kernels.push_back(kernel);
+            }
+            return true;
+        } catch (const std::exception& e) {
+            log_warning("Could not read benchmark baseline " + path.string() + ": " + std::string(e.what()));
+            return false;
+        }
+    }
+
+    size_t compareReports(const Report& baseline, const Report& current, double threshold, std::ostream& out) {
+        if (!(baseline.fingerprint == current.fingerprint)) {
+            out << "warning: the baseline was recorded on a different machine or compiler; differences may not be regressions\n"
+                << "  baseline: " << baseline.fingerprint.cpu << ", " << baseline.fingerprint.system << ", " << baseline.fingerprint.compiler << '\n'
+                << "  this run: " << current.fingerprint.cpu << ", " << current.fingerprint.system << ", " << current.fingerprint.compiler << '\n';
+        }
+
+        out << std::left << std::setw(44) << "kernel" << std::right << std::setw(14) << "baseline" << std::setw(14) << "now" << std::setw(10) << "change"
+            << std::setw(8) << "z" << "  verdict\n";
+        size_t regressions = 0;
+        for (const KernelResult& kernel : current.kernels) {
+            auto base = std::find_if(baseline.kernels.begin(), baseline.kernels.end(), [&kernel](const KernelResult& entry) { return entry.name == kernel.name; });
+            out << std::left << std::setw(44) << kernel.name << std::right << std::fixed << std::setprecision(1);
+            if (base == baseline.kernels.end()) {
+                out << std::setw(14) << "-" << std::setw(12) << kernel.medianNs << "ns" << std::setw(10) << "-" << std::setw(8) << "-" << "  new\n";
+                continue;
+            }
+
+            const double change = base->medianNs > 0.0 ? (kernel.medianNs - base->medianNs) / base->medianNs : 0.0;
+            const double error = std::hypot(medianError(kernel), medianError(*base));
+            const double z = error > 0.0 ? (kernel.medianNs - base->medianNs) / error : (kernel.medianNs > base->medianNs ? INFINITY : 0.0);
+            const bool regressed = change > threshold && z > GATE_SIGNIFICANCE;
+            const char* verdict = regressed ? "REGRESSED" : (change < -threshold && z < -GATE_SIGNIFICANCE ? "faster" : "ok");
+            if (regressed) ++regressions;
+
+            out << std::setw(12) << base->medianNs << "ns" << std::setw(12) << kernel.medianNs << "ns" << std::setw(9) << change * 100.0 << '%'
+                << std::setw(8) << std::setprecision(1) << z << "  " << verdict << '\n';
+        }
+        for (const KernelResult& base : baseline.kernels) {
+            bool ran = std::any_of(current.kernels.begin(), current.kernels.end(), [&base](const KernelResult& kernel) { return kernel.name == base.name; });
+            if (!ran) out << std::left << std::setw(44) << base.name << "  not run\n";
+        }
+        out << std::defaultfloat << '\n' << regressions << " of " << current.kernels.size() << " kernels regressed by more than " << threshold * 100.0 << "% (z > "
+            << GATE_SIGNIFICANCE << ")\n";
+        return regressions;
+    }
+}
+
+CATCH_REGISTER_LISTENER(perf::PerfListener)
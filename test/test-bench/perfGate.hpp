@@ -0,0 +1,53 @@
+//
+//  perfGate.hpp
+//  sfml game template
+//
+//  Performance regression gate for kernel_bench. A Catch2 listener keeps every benchmark's raw samples, and after the
+//  run they are summarized (median and median absolute deviation, which one noisy sample cannot drag) and written as
+//  JSON. Given a baseline, the run fails if a kernel is slower by more than the threshold and by more than the noise of both
+//  runs. `make bench_baseline` records one; --perf-baseline compares against it.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <filesystem>
+
+namespace perf {
+
+    constexpr double GATE_THRESHOLD = 0.10; // a kernel this much slower than its baseline median (as a fraction) regresses...
+    constexpr double GATE_SIGNIFICANCE = 3.0; // ...if the slowdown is also this many standard errors of the two medians
+
+    struct KernelResult {
+        std::string name;
+        double medianNs = 0.0; // per run of the benchmark body
+        double madNs = 0.0;
+        int iterations = 0; // body runs per sample
+        unsigned samples = 0;
+    };
+
+    struct Fingerprint {
+        std::string system; // OS, release and architecture
+        std::string cpu;
+        std::string compiler;
+        unsigned threads = 0;
+        bool operator==(const Fingerprint& other) const { return system == other.system && cpu == other.cpu && compiler == other.compiler && threads == other.threads; }
+    };
+
+    struct Report {
+        Fingerprint fingerprint;
+        std::vector<KernelResult> kernels;
+    };
+
+    Fingerprint machineFingerprint();
+    KernelResult summarize(const std::string& name, std::vector<double> samplesNs, int iterations);
+    const std::vector<KernelResult>& recordedKernels(); // everything the listener saw this run, in order
+
+    bool writeReport(const std::filesystem::path& path, const Report& report);
+    bool readReport(const std::filesystem::path& path, Report& report);
+
+    // prints a table of every kernel against the baseline and returns how many regressed
+    size_t compareReports(const Report& baseline, const Report& current, double threshold, std::ostream& out);
+}
@@ -0,0 +1,66 @@
+//
+//  worldBench.cpp
+//  sfml game template
+//
+//  Batch throughput of independent world instances: the same set of bot playthroughs (mazes from fixed seeds, alternating
+//  generators) is created and run to the goal with 1, 2, 4 ... threads, and simulation ticks per second and the speedup
+//  over one thread are printed. Build and run with `make bench_worlds` (WORLDS_ARGS="<worlds> <maze size>" to change them).
+//
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include "game/world/world.hpp"
+
+namespace {
+    constexpr size_t DEFAULT_WORLD_COUNT = 2000;
+    constexpr size_t DEFAULT_MAZE_SIZE = 31;
+}
+
+int main(int argc, char* argv[]) {
+    Constants::readFromYaml(std::filesystem::path("test/test-src/game/globals/config.yaml"));
+
+    const size_t worldCount = argc > 1 ? std::stoul(argv[1]) : DEFAULT_WORLD_COUNT;
+    const size_t mazeSize = (argc > 2 ? std::stoul(argv[2]) : DEFAULT_MAZE_SIZE) | 1; // generators need odd sizes
+
+    std::vector<world::WorldSettings> settings;
+    for (size_t i = 0; i < worldCount; ++i) {
+        auto generator = (i % 2) ? world::MazeGenerator::Prim : world::MazeGenerator::DFS;
+        world::WorldSettings worldSettings = world::WorldSettings::fromConfig(static_cast<std::uint32_t>(i + 1), generator);
+        worldSettings.mazeWidth = worldSettings.mazeHeight = mazeSize;
+        settings.push_back(worldSettings);
+    }
+
+    unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < hardwareThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(hardwareThreads);
+
+    std::cout << worldCount << " worlds of " << mazeSize << "x" << mazeSize << ", run to the goal\n";
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "create ms" << std::setw(12) << "run ms" << std::setw(14) << "ticks/s"
+              << std::setw(10) << "speedup" << std::setw(10) << "solved" << '\n';
+
+    double singleThreadRate = 0.0;
+    std::uint64_t expectedTicks = 0;
+    for (unsigned threads : threadCounts) {
+        jobs::JobSystem system(threads - 1); // the calling thread is the last one
+        world::BatchResult created;
+        world::Worlds worlds = world::createWorlds(settings, system, &created);
+        world::BatchResult result = world::runBatch(worlds, system);
+
+        if (threads == 1) {
+            singleThreadRate = result.ticksPerSecond;
+            expectedTicks = result.ticks;
+        } else if (result.ticks != expectedTicks) { // instances share nothing, so thread count must not change a run
+            std::cerr << "runs diverged with " << threads << " threads: " << result.ticks << " ticks instead of " << expectedTicks << '\n';
+            return 1;
+        }
+
+        std::cout << std::fixed << std::setw(8) << threads << std::setprecision(1) << std::setw(12) << created.createMs
+                  << std::setw(12) << result.runMs << std::setprecision(0) << std::setw(14) << result.ticksPerSecond
+                  << std::setprecision(2) << std::setw(10) << (singleThreadRate > 0.0 ? result.ticksPerSecond / singleThreadRate : 0.0)
+                  << std::setw(10) << result.solved << '\n';
+    }
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "log.hpp"
+#include "memoryStats.hpp"
 
 #if ENABLE_LOGGING
 
@@ -51,11 +52,13 @@ public:
     }
 
     void log(const std::string& message, spdlog::level::level_enum level) {
+        memory::Scope memoryScope(memory::Tag::Logging);
         log_queue_.push({message, level});
     }
 
 private:
     void processLogQueue() {
+        memory::Scope memoryScope(memory::Tag::Logging); // everything spdlog formats and buffers on this thread
         LogEntry entry;
         while (!stop_thread_ && log_queue_.pop(entry)) {
             auto logger = spdlog::get(entry.level == spdlog::level::err ? "error_logger" : "info_logger");
@@ -95,6 +98,7 @@ void log_error(const std::string& message) {
 
 // Logging initialization and cleanup
 void init_logging() {
+    memory::Scope memoryScope(memory::Tag::Logging);
     std::string info_log_file = "test/test-logging/loggingFiles/info.txt";
     std::string error_log_file = "test/test-logging/loggingFiles/errors.txt";
 
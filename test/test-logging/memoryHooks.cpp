@@ -0,0 +1,39 @@
+//
+//  memoryHooks.cpp
+//  sfml game template
+//
+//  Global operator new and delete replacements that route every allocation through memory::allocate and memory::release, so
+//  memoryStats.hpp can charge it to a tag. Linked only into programs that report a footprint (see memoryStats.hpp).
+//
+
+#include "memoryStats.hpp"
+
+#include <new>
+
+namespace {
+    void* allocateOrThrow(size_t size) {
+        for (;;) {
+            if (void* pointer = memory::allocate(size)) return pointer;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
+}
+
+// global replacements; the array, sized and nothrow forms all come down to allocateOrThrow and memory::release
+void* operator new(size_t size) { return allocateOrThrow(size); }
+void* operator new[](size_t size) { return allocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return allocateOrThrow(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return allocateOrThrow(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* pointer) noexcept { memory::release(pointer); }
+void operator delete[](void* pointer) noexcept { memory::release(pointer); }
+void operator delete(void* pointer, size_t) noexcept { memory::release(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { memory::release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { memory::release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { memory::release(pointer); }
@@ -0,0 +1,143 @@
+//
+//  memoryStats.cpp
+//  sfml game template
+//
+
+#include "memoryStats.hpp"
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <unistd.h>
+#include <sys/resource.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+namespace memory {
+
+    namespace {
+        // sized to max_align_t, so the pointer handed out is aligned as well as malloc's
+        struct alignas(std::max_align_t) Header {
+            size_t size;
+            Tag tag;
+        };
+
+        struct Counters {
+            std::atomic<std::int64_t> live { 0 };
+            std::atomic<std::int64_t> peak { 0 };
+            std::atomic<std::uint64_t> allocations { 0 };
+            std::atomic<std::uint64_t> frees { 0 };
+        };
+
+        // both constant initialized, so they are ready for allocations made during static initialization
+        Counters counters[TAG_COUNT];
+        thread_local Tag currentTag = Tag::Untagged;
+
+        std::string formatBytes(double bytes) {
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(1);
+            if (bytes < 1024.0 * 1024.0) text << bytes / 1024.0 << " KB";
+            else text << bytes / (1024.0 * 1024.0) << " MB";
+            return text.str();
+        }
+    }
+
+    const char* tagName(Tag tag) {
+        switch (tag) {
+            case Tag::Untagged: return "untagged";
+            case Tag::TileMap: return "tilemap";
+            case Tag::Generators: return "generators";
+            case Tag::Pathfinding: return "pathfinding";
+            case Tag::Assets: return "assets";
+            case Tag::Logging: return "logging";
+        }
+        return "unknown";
+    }
+
+    void* allocate(size_t size) {
+        void* raw = std::malloc(sizeof(Header) + size);
+        if (!raw) return nullptr;
+        Header* header = new (raw) Header { size, currentTag };
+
+        Counters& tag = counters[static_cast<size_t>(header->tag)];
+        const std::int64_t live = tag.live.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed) + static_cast<std::int64_t>(size);
+        std::int64_t peak = tag.peak.load(std::memory_order_relaxed);
+        while (live > peak && !tag.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        tag.allocations.fetch_add(1, std::memory_order_relaxed);
+        return header + 1;
+    }
+
+    void release(void* pointer) noexcept {
+        if (!pointer) return;
+        Header* header = static_cast<Header*>(pointer) - 1;
+        Counters& tag = counters[static_cast<size_t>(header->tag)];
+        tag.live.fetch_sub(static_cast<std::int64_t>(header->size), std::memory_order_relaxed);
+        tag.frees.fetch_add(1, std::memory_order_relaxed);
+        std::free(header);
+    }
+
+    Scope::Scope(Tag tag) : previous(currentTag) { currentTag = tag; }
+    Scope::~Scope() { currentTag = previous; }
+
+    TagStats tagStats(Tag tag) {
+        const Counters& counter = counters[static_cast<size_t>(tag)];
+        TagStats stats;
+        stats.liveBytes = counter.live.load(std::memory_order_relaxed);
+        stats.peakBytes = counter.peak.load(std::memory_order_relaxed);
+        stats.allocations = counter.allocations.load(std::memory_order_relaxed);
+        stats.frees = counter.frees.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void resetPeaks() {
+        for (Counters& counter : counters) counter.peak.store(counter.live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    size_t residentBytes() {
+#if defined(__APPLE__)
+        mach_task_basic_info info {};
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) return 0;
+        return info.resident_size;
+#else
+        std::ifstream statm("/proc/self/statm");
+        size_t totalPages = 0, residentPages = 0;
+        if (!(statm >> totalPages >> residentPages)) return 0;
+        return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    size_t peakResidentBytes() {
+        rusage usage {};
+        if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+        return static_cast<size_t>(usage.ru_maxrss); // bytes on macOS
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024; // kilobytes on Linux
+#endif
+    }
+
+    std::string footprintReport() {
+        std::ostringstream report;
+        report << "Memory footprint: RSS " << formatBytes(residentBytes()) << ", peak RSS " << formatBytes(peakResidentBytes()) << "\n\t"
+               << std::left << std::setw(14) << "tag" << std::right << std::setw(12) << "live" << std::setw(12) << "peak"
+               << std::setw(14) << "allocations" << std::setw(12) << "live count";
+
+        std::int64_t totalLive = 0;
+        std::uint64_t totalAllocations = 0;
+        for (size_t i = 0; i < TAG_COUNT; ++i) {
+            const TagStats stats = tagStats(static_cast<Tag>(i));
+            totalLive += stats.liveBytes;
+            totalAllocations += stats.allocations;
+            report << "\n\t" << std::left << std::setw(14) << tagName(static_cast<Tag>(i)) << std::right << std::setw(12) << formatBytes(stats.liveBytes)
+                   << std::setw(12) << formatBytes(stats.peakBytes) << std::setw(14) << stats.allocations << std::setw(12) << stats.allocations - stats.frees;
+        }
+        report << "\n\t" << std::left << std::setw(14) << "total" << std::right << std::setw(12) << formatBytes(totalLive);
+        if (!totalAllocations) report << "\n\t(no allocation was counted: this program does not link memoryHooks.cpp)";
+        return report.str();
+    }
+}
@@ -0,0 +1,56 @@
+//
+//  memoryStats.hpp
+//  sfml game template
+//
+//  Tagged memory accounting. memoryHooks.cpp replaces the global operator new and delete with allocate and release below:
+//  every allocation carries a small header with its size and the tag that was current on the allocating thread, so it is
+//  charged back to that tag when it is freed, wherever that happens. Code opts in by opening a Scope around its work; anything
+//  else counts as untagged. Only the game and memory_bench link memoryHooks.cpp; the timing benchmarks leave it out, so
+//  their allocations cost what the plain allocator costs, and Scopes there only set a thread-local.
+//
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace memory {
+
+    enum class Tag : std::uint8_t { Untagged, TileMap, Generators, Pathfinding, Assets, Logging };
+    constexpr size_t TAG_COUNT = 6;
+
+    const char* tagName(Tag tag);
+
+    // allocations on this thread are charged to tag until the scope closes; scopes nest
+    class Scope {
+    public:
+        explicit Scope(Tag tag);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Tag previous;
+    };
+
+    struct TagStats {
+        std::int64_t liveBytes = 0;
+        std::int64_t peakBytes = 0; // highest liveBytes since start or the last resetPeaks
+        std::uint64_t allocations = 0;
+        std::uint64_t frees = 0;
+    };
+
+    TagStats tagStats(Tag tag);
+    void resetPeaks(); // peaks drop to what is live now, so the next peak is one phase's
+
+    size_t residentBytes(); // process RSS, 0 where it cannot be read
+    size_t peakResidentBytes();
+
+    // one table of every tag plus RSS, for the log
+    std::string footprintReport();
+
+    // the accounting allocator behind memoryHooks.cpp; allocate returns nullptr when out of memory
+    void* allocate(size_t size);
+    void release(void* pointer) noexcept;
+}
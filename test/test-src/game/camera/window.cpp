@@ -1,8 +1,266 @@
+
 #include "window.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 
-GameWindow::GameWindow(unsigned int screenWidth, unsigned int screenHeight, std::string gameTitle, unsigned int frameRate ) : window(sf::VideoMode(screenWidth, screenHeight), gameTitle,  sf::Style::Titlebar | sf::Style::Close) {
-    window.setFramerateLimit(frameRate); 
+void FrameSnapshot::reset(sf::Color newClearColor) {
+    clearColor = newClearColor;
+    for (size_t i = 0; i < usedLayers; ++i) layers[i].items.clear();
+    usedLayers = 0;
+    inputTimestamps.clear();
+    ++frameIndex;
 }
 
-GameView::GameView(sf::FloatRect viewRect) : view(sf::View(viewRect)){}
+void FrameSnapshot::beginLayer(const sf::View& view) {
+    if (usedLayers == layers.size()) layers.emplace_back();
+    layers[usedLayers].view = view;
+    ++usedLayers;
+}
+
+void FrameSnapshot::replay(sf::RenderTarget& target) const {
+    target.clear(clearColor);
+    for (size_t i = 0; i < usedLayers; ++i) {
+        target.setView(layers[i].view);
+        for (const auto& item : layers[i].items) {
+            std::visit([&target](const auto& drawable) { target.draw(drawable); }, item);
+        }
+    }
+}
+
+void FrameSnapshotBuffer::publish() {
+    writeIndex = middleIndex.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel) & ~FRESH_BIT;
+    std::lock_guard<std::mutex> lock(mutex);
+    changed.notify_all();
+}
+
+const FrameSnapshot* FrameSnapshotBuffer::acquireLatest(std::chrono::milliseconds timeout) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait_for(lock, timeout, [this] { return stopped || (middleIndex.load(std::memory_order_acquire) & FRESH_BIT); });
+    }
+    if (stopped || !(middleIndex.load(std::memory_order_acquire) & FRESH_BIT)) return nullptr;
+
+    readIndex = middleIndex.exchange(readIndex, std::memory_order_acq_rel) & ~FRESH_BIT;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        changed.notify_all();
+    }
+    return &slots[readIndex];
+}
+
+bool FrameSnapshotBuffer::waitUntilConsumed(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return changed.wait_for(lock, timeout, [this] { return stopped || !(middleIndex.load(std::memory_order_acquire) & FRESH_BIT); });
+}
+
+void FrameSnapshotBuffer::stop() {
+    stopped = true;
+    std::lock_guard<std::mutex> lock(mutex);
+    changed.notify_all();
+}
+
+std::string FrameStatsSummary::toString() const {
+    char line[160];
+    std::snprintf(line, sizeof(line), "frame %.2fms (target %.2f)  jitter %.2fms  min %.2f  max %.2f  p99 %.2f  missed %zu",
+                  meanMs, targetMs, stdDevMs, minMs, maxMs, p99Ms, missedFrames);
+    return line;
+}
+
+void FrameStats::recordPresent(float intervalSeconds, float target) {
+    std::lock_guard<std::mutex> lock(mutex);
+    intervals[next] = intervalSeconds;
+    next = (next + 1) % WINDOW_SIZE;
+    count = std::min(count + 1, WINDOW_SIZE);
+    targetSeconds = target;
+    if (target > 0.0f && intervalSeconds > target * 1.5f) ++missedFrames;
+}
+
+FrameStatsSummary FrameStats::summary() const {
+    std::array<float, WINDOW_SIZE> sorted;
+    FrameStatsSummary result;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::copy(intervals.begin(), intervals.begin() + count, sorted.begin());
+        result.samples = count;
+        result.missedFrames = missedFrames;
+        result.targetMs = targetSeconds * 1000.0f;
+    }
+    if (result.samples == 0) return result;
+
+    auto begin = sorted.begin();
+    auto end = sorted.begin() + result.samples;
+    std::sort(begin, end);
+
+    double sum = 0.0, sumSquares = 0.0;
+    for (auto it = begin; it != end; ++it) { sum += *it; sumSquares += double(*it) * *it; }
+    double mean = sum / result.samples;
+
+    result.meanMs = static_cast<float>(mean * 1000.0);
+    result.stdDevMs = static_cast<float>(std::sqrt(std::max(0.0, sumSquares / result.samples - mean * mean)) * 1000.0);
+    result.minMs = *begin * 1000.0f;
+    result.maxMs = *(end - 1) * 1000.0f;
+    result.p99Ms = sorted[std::min(result.samples - 1, result.samples * 99 / 100)] * 1000.0f;
+    return result;
+}
+
+std::string LatencySummary::toString() const {
+    char line[96];
+    std::snprintf(line, sizeof(line), "input to display %.2fms  p99 %.2f  max %.2f  (%zu inputs)", meanMs, p99Ms, maxMs, samples);
+    return line;
+}
+
+void LatencyStats::record(float latencySeconds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    latencies[next] = latencySeconds;
+    next = (next + 1) % WINDOW_SIZE;
+    count = std::min(count + 1, WINDOW_SIZE);
+}
+
+LatencySummary LatencyStats::summary() const {
+    std::array<float, WINDOW_SIZE> sorted;
+    LatencySummary result;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::copy(latencies.begin(), latencies.begin() + count, sorted.begin());
+        result.samples = count;
+    }
+    if (result.samples == 0) return result;
+
+    std::sort(sorted.begin(), sorted.begin() + result.samples);
+    double sum = 0.0;
+    for (size_t i = 0; i < result.samples; ++i) sum += sorted[i];
+
+    result.meanMs = static_cast<float>(sum / result.samples * 1000.0);
+    result.p99Ms = sorted[std::min(result.samples - 1, result.samples * 99 / 100)] * 1000.0f;
+    result.maxMs = sorted[result.samples - 1] * 1000.0f;
+    return result;
+}
+
+void FramePacer::setTargetRate(unsigned int framesPerSecond) {
+    configuredInterval = framesPerSecond ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond)) : Clock::duration::zero();
+    targetInterval = configuredInterval;
+    nextDeadline = {};
+}
+
+void FramePacer::waitForNextFrame() {
+    if (targetInterval == Clock::duration::zero()) return;
 
+    Clock::time_point now = Clock::now();
+    if (nextDeadline == Clock::time_point{} || now - nextDeadline > targetInterval / 4) { // first frame, or late: resync instead of rushing the next one
+        nextDeadline = now + targetInterval;
+        return;
+    }
+
+    Clock::time_point sleepUntil = nextDeadline - spinMargin;
+    if (now < sleepUntil) {
+        std::this_thread::sleep_until(sleepUntil);
+        float overshoot = std::chrono::duration<float>(Clock::now() - sleepUntil).count();
+        sleepOvershootAverage += (overshoot - sleepOvershootAverage) * 0.1f;
+
+        auto margin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(sleepOvershootAverage * 2.0f)) + MIN_SPIN_MARGIN;
+        spinMargin = std::clamp<Clock::duration>(margin, MIN_SPIN_MARGIN, MAX_SPIN_MARGIN);
+    }
+    while ((now = Clock::now()) < nextDeadline) std::this_thread::yield(); // the last fraction of a millisecond
+
+    bool overslept = now - nextDeadline > targetInterval / 4;
+    nextDeadline = overslept ? now + targetInterval : nextDeadline + targetInterval;
+}
+
+// When display() itself blocks, the driver is pacing to the monitor. Pacing to a whole number of its measured refresh periods
+// then avoids beating against it (e.g. a 60fps target on a 59.94Hz panel)
+void FramePacer::recordDisplay(Clock::duration displayCall, Clock::duration presentInterval) {
+    if (!adaptive || configuredInterval == Clock::duration::zero()) return;
+
+    if (displayCall < BLOCKING_DISPLAY) {
+        blockingPresents = 0;
+        if (targetInterval != configuredInterval) {
+            targetInterval = configuredInterval;
+            log_info("Frame pacer back to the configured interval");
+        }
+        return;
+    }
+
+    float period = std::chrono::duration<float>(presentInterval).count();
+    displayPeriodAverage = blockingPresents ? displayPeriodAverage + (period - displayPeriodAverage) * 0.05f : period;
+    if (++blockingPresents < ADAPT_AFTER_PRESENTS || displayPeriodAverage <= 0.0f) return;
+
+    float configured = std::chrono::duration<float>(configuredInterval).count();
+    float refreshes = std::max(1.0f, std::round(configured / displayPeriodAverage));
+    auto adapted = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(displayPeriodAverage * refreshes));
+
+    auto difference = adapted > targetInterval ? adapted - targetInterval : targetInterval - adapted;
+    if (difference > std::chrono::microseconds(100)) {
+        targetInterval = adapted;
+        log_info("Frame pacer adapted to display: " + std::to_string(displayPeriodAverage * 1000.0f) + "ms refresh, " + std::to_string(static_cast<int>(refreshes)) + " per frame");
+    }
+}
+
+GameWindow::GameWindow(unsigned int screenWidth, unsigned int screenHeight, std::string gameTitle, unsigned int frameRate, bool openWindow ) {
+    if (openWindow) window.create(sf::VideoMode(screenWidth, screenHeight), gameTitle,  sf::Style::Titlebar | sf::Style::Close);
+    pacer.setTargetRate(frameRate); // instead of window.setFramerateLimit
+}
+
+GameWindow::~GameWindow() {
+    stopRenderThread();
+}
+
+// the window's GL context can only be active on one thread, so the caller gives it up before the render thread takes it
+void GameWindow::startRenderThread(FrameSnapshotBuffer& snapshots) {
+    if (renderThreadRunning) return;
+
+    window.setActive(false);
+    activeSnapshots = &snapshots;
+    renderThreadRunning = true;
+    renderThread = std::thread(&GameWindow::renderLoop, this, std::ref(snapshots));
+    log_info("Render thread started");
+}
+
+void GameWindow::stopRenderThread() {
+    if (!renderThreadRunning) return;
+
+    renderThreadRunning = false;
+    if (activeSnapshots) activeSnapshots->stop();
+    if (renderThread.joinable()) renderThread.join();
+    activeSnapshots = nullptr;
+
+    window.setActive(true);
+    log_info("Render thread stopped");
+}
+
+void GameWindow::setPacing(bool verticalSync, bool adaptive) {
+    window.setVerticalSyncEnabled(verticalSync);
+    pacer.setAdaptive(adaptive);
+}
+
+void GameWindow::present(const std::vector<std::chrono::steady_clock::time_point>& inputTimestamps) {
+    pacer.waitForNextFrame();
+
+    auto displayStart = FramePacer::Clock::now();
+    window.display();
+    auto displayEnd = FramePacer::Clock::now();
+
+    if (lastPresent != FramePacer::Clock::time_point{}) {
+        auto interval = displayEnd - lastPresent;
+        frameStats.recordPresent(std::chrono::duration<float>(interval).count(), pacer.getTargetSeconds());
+        pacer.recordDisplay(displayEnd - displayStart, interval);
+    }
+    lastPresent = displayEnd;
+
+    for (const auto& inputTime : inputTimestamps) inputLatencyStats.record(std::chrono::duration<float>(displayEnd - inputTime).count());
+}
+
+void GameWindow::renderLoop(FrameSnapshotBuffer& snapshots) {
+    window.setActive(true);
+
+    while (renderThreadRunning) {
+        const FrameSnapshot* frame = snapshots.acquireLatest(std::chrono::milliseconds(100));
+        if (!frame) continue;
+
+        frame->replay(window);
+        present(frame->inputTimestamps); // pacing and vsync blocking happen here, off the simulation thread
+    }
+    window.setActive(false);
+}
+
+GameView::GameView(sf::FloatRect viewRect) : view(sf::View(viewRect)){}
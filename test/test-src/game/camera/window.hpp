@@ -1,21 +1,191 @@
+
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <variant>
+#include <vector>
+#include <array>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <string>
 #include "../test-logging/log.hpp" 
 
+// vertices drawn with a texture that lives for the whole game (the tile sheet or its mip chain), so only the pointer is kept
+struct TexturedVertices : public sf::Drawable {
+    TexturedVertices(const sf::VertexArray& vertexArray, const sf::Texture* vertexTexture) : vertices(vertexArray), texture(vertexTexture) {}
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        states.texture = texture;
+        target.draw(vertices, states);
+    }
+
+    sf::VertexArray vertices;
+    const sf::Texture* texture = nullptr;
+};
+
+// One frame's worth of drawing: the views and copies of everything drawn in them, in draw order. Once published it is
+// only read, so the render thread can replay it while the simulation moves on to the next tick
+struct FrameSnapshot {
+    using DrawItem = std::variant<sf::Sprite, sf::Text, sf::RectangleShape, sf::VertexArray, TexturedVertices>;
+
+    struct Layer {
+        sf::View view;
+        std::vector<DrawItem> items;
+    };
+
+    void reset(sf::Color newClearColor);
+    void beginLayer(const sf::View& view);
+    template<typename T> void add(T&& item) { if (usedLayers) layers[usedLayers - 1].items.emplace_back(std::forward<T>(item)); }
+    void replay(sf::RenderTarget& target) const;
+
+    sf::Color clearColor = sf::Color::Black;
+    std::vector<Layer> layers; // kept between frames so item vectors keep their capacity
+    std::vector<std::chrono::steady_clock::time_point> inputTimestamps; // inputs this frame is the first to show
+    size_t usedLayers = 0;
+    size_t frameIndex = 0;
+};
+
+// Lock-free triple buffer of snapshots: the producer always has a slot to write, the consumer always reads the newest
+// complete one, and neither ever waits on the other's slot
+class FrameSnapshotBuffer {
+public:
+    FrameSnapshot& beginWrite() { return slots[writeIndex]; }
+    void publish(); 
+    const FrameSnapshot* acquireLatest(std::chrono::milliseconds timeout); // nullptr on timeout or stop
+    bool waitUntilConsumed(std::chrono::milliseconds timeout); // producer backpressure: the last published frame was picked up
+    void stop(); 
+
+private:
+    static constexpr int FRESH_BIT = 4;
+
+    std::array<FrameSnapshot, 3> slots;
+    int writeIndex = 0; // producer only
+    int readIndex = 1;  // consumer only
+    std::atomic<int> middleIndex {2}; // slot index, plus FRESH_BIT while it holds a frame the consumer has not taken
+    std::atomic<bool> stopped {false};
+
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+struct FrameStatsSummary {
+    float meanMs = 0.0f;
+    float stdDevMs = 0.0f; // frame-to-frame jitter
+    float minMs = 0.0f;
+    float maxMs = 0.0f;
+    float p99Ms = 0.0f;
+    float targetMs = 0.0f;
+    size_t samples = 0;
+    size_t missedFrames = 0; // presents later than 1.5 target intervals, since start
+
+    std::string toString() const;
+};
+
+// rolling window of measured present-to-present intervals; written by whichever thread presents, read by the overlay
+class FrameStats {
+public:
+    static constexpr size_t WINDOW_SIZE = 240;
+
+    void recordPresent(float intervalSeconds, float targetSeconds); 
+    FrameStatsSummary summary() const; 
+
+private:
+    mutable std::mutex mutex;
+    std::array<float, WINDOW_SIZE> intervals {};
+    size_t count = 0;
+    size_t next = 0;
+    size_t missedFrames = 0;
+    float targetSeconds = 0.0f;
+};
+
+struct LatencySummary {
+    float meanMs = 0.0f;
+    float p99Ms = 0.0f;
+    float maxMs = 0.0f;
+    size_t samples = 0;
+
+    std::string toString() const;
+};
+
+// rolling window of input-to-present latencies: from the input event's poll timestamp to the display() of the first frame showing it
+class LatencyStats {
+public:
+    static constexpr size_t WINDOW_SIZE = 128;
+
+    void record(float latencySeconds); 
+    LatencySummary summary() const; 
+
+private:
+    mutable std::mutex mutex;
+    std::array<float, WINDOW_SIZE> latencies {};
+    size_t count = 0;
+    size_t next = 0;
+};
+
+/* FramePacer replaces sf::Window::setFramerateLimit, whose sf::sleep overshoots by up to a scheduler quantum. It sleeps until 
+just before the deadline (the margin follows the measured sleep overshoot) and spins the rest on the steady clock. Deadlines 
+advance by whole intervals, so small wake-up errors do not accumulate; a frame that is clearly late restarts the schedule */
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void setTargetRate(unsigned int framesPerSecond); // 0 disables pacing
+    void setAdaptive(bool enabled) { adaptive = enabled; }
+    void waitForNextFrame(); 
+    void recordDisplay(Clock::duration displayCall, Clock::duration presentInterval); // adapts to the display when display() blocks on vsync
+    float getTargetSeconds() const { return std::chrono::duration<float>(targetInterval).count(); }
+
+private:
+    static constexpr std::chrono::microseconds MIN_SPIN_MARGIN {200};
+    static constexpr std::chrono::microseconds MAX_SPIN_MARGIN {4000};
+    static constexpr std::chrono::microseconds BLOCKING_DISPLAY {500}; // a display() this long was held by the driver
+    static constexpr int ADAPT_AFTER_PRESENTS = 30;
+
+    Clock::duration configuredInterval {};
+    Clock::duration targetInterval {};
+    Clock::time_point nextDeadline {};
+    Clock::duration spinMargin = std::chrono::milliseconds(1);
+    float sleepOvershootAverage = 0.0f; // seconds
+
+    bool adaptive = false;
+    int blockingPresents = 0;
+    float displayPeriodAverage = 0.0f; // seconds
+};
 
 class GameWindow{
 public: 
-    GameWindow( unsigned int screenWidth, unsigned int screenHeight, std::string gameTitle, unsigned int frameRate );
+    GameWindow( unsigned int screenWidth, unsigned int screenHeight, std::string gameTitle, unsigned int frameRate, bool openWindow = true ); // false: headless, nothing is shown
     sf::RenderWindow& getWindow() { return window; } 
-    ~GameWindow() = default;
+    ~GameWindow(); 
 
     explicit operator bool() const {
         return window.getSize().x > 0 && window.getSize().y > 0;
     }
 
+    // pipelined mode: a dedicated thread owns the GL context, replays the newest snapshot and presents it
+    void startRenderThread(FrameSnapshotBuffer& snapshots); 
+    void stopRenderThread(); 
+    bool isRenderThreadRunning() const { return renderThreadRunning; }
+
+    void setPacing(bool verticalSync, bool adaptive); 
+    void present(const std::vector<std::chrono::steady_clock::time_point>& inputTimestamps = {}); // paced window.display(); records frame and input latency stats
+    const FrameStats& getFrameStats() const { return frameStats; }
+    const LatencyStats& getInputLatencyStats() const { return inputLatencyStats; }
+
 private:
+    void renderLoop(FrameSnapshotBuffer& snapshots); 
+
     sf::RenderWindow window;
+    FramePacer pacer;
+    FrameStats frameStats;
+    LatencyStats inputLatencyStats;
+    FramePacer::Clock::time_point lastPresent {};
+
+    std::thread renderThread;
+    std::atomic<bool> renderThreadRunning {false};
+    FrameSnapshotBuffer* activeSnapshots = nullptr;
 };
 
 class GameView{
@@ -33,4 +203,3 @@ private:
     sf::View view; 
 
 };
-
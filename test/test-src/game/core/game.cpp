@@ -2,8 +2,9 @@
 #include "game.hpp" 
 
 // GameManager constructor sets up the window, intitializes constant variables, calls the random function, and makes scenes 
-GameManager::GameManager()
-    : mainWindow(Constants::WORLD_WIDTH, Constants::WORLD_HEIGHT, Constants::GAME_TITLE, Constants::FRAME_LIMIT) {
+GameManager::GameManager(const RunOptions& runOptions)
+    : mainWindow(Constants::WORLD_WIDTH, Constants::WORLD_HEIGHT, Constants::GAME_TITLE, Constants::FRAME_LIMIT, runOptions.replayPath.empty()), options(runOptions) {
+    mainWindow.setPacing(Constants::VSYNC, Constants::ADAPTIVE_PACING);
     gameScene = std::make_unique<gamePlayScene>(mainWindow.getWindow());
 
     log_info("\tGame initialized");
@@ -11,76 +12,196 @@ GameManager::GameManager()
 
 // runGame calls to createAssets from scenes and loops until window is closed to run scene events 
 void GameManager::runGame() {
+    if (!options.replayPath.empty()) {
+        runReplay();
+        return;
+    }
     try {     
         loadScenes(); 
+        log_info(memory::footprintReport());
+        if (!options.recordPath.empty()) recorder.begin(options.recordPath, Constants::TICK_RATE, Constants::MAZE_SEED, Constants::CONFIG_HASH);
+        if (Constants::PIPELINED_RENDERING) mainWindow.startRenderThread(frameSnapshots);
 
         while (mainWindow.getWindow().isOpen()) {
             countTime();
             handleEventInput();
-            runScenesFlags(); 
-            resetFlags();
+            runSimulationTicks();
+            updateStatsOverlay(); 
+            renderScenes(); 
         }
+        recorder.finish(); 
+        log_info(memory::footprintReport());
         log_info("\tGame Ended\n"); 
             
     } catch (const std::exception& e) {
         log_error("Exception in runGame: " + std::string(e.what())); 
+        mainWindow.stopRenderThread(); 
         mainWindow.getWindow().close(); 
     }
 }
 
+// runScenesFlags advances the active scene by one fixed simulation tick
 void GameManager::runScenesFlags(){
     if(!FlagSystem::flagEvents.gameEnd){
-        if(FlagSystem::gameScene1Flags.sceneStart && !FlagSystem::gameScene1Flags.sceneEnd) gameScene->runScene();
+        if(FlagSystem::gameScene1Flags.sceneStart && !FlagSystem::gameScene1Flags.sceneEnd) gameScene->runSimulationTick();
     }
     
 }
 
+/* renderScenes draws the active scene once, interpolated between the last two ticks. In pipelined mode it only records a 
+snapshot for the render thread, after that thread has picked up the previous one, so simulating the next frame overlaps drawing this one. After gameEnd the ticks stop but the ending screen is still drawn */
+void GameManager::renderScenes(){
+    if(!mainWindow.getWindow().isOpen() || !FlagSystem::gameScene1Flags.sceneStart || FlagSystem::gameScene1Flags.sceneEnd){
+        unpresentedInputs.clear(); // no frame is drawn to show them, so they would only pile up
+        return;
+    }
+
+    if(mainWindow.isRenderThreadRunning()){
+        if(!frameSnapshots.waitUntilConsumed(std::chrono::milliseconds(100))) return; 
+        FrameSnapshot& snapshot = frameSnapshots.beginWrite();
+        gameScene->recordFrame(snapshot);
+        snapshot.inputTimestamps.swap(unpresentedInputs); // this frame is the first to show those inputs
+        frameSnapshots.publish();
+    } else {
+        gameScene->renderFrame();
+        mainWindow.present(unpresentedInputs); 
+    }
+    unpresentedInputs.clear();
+}
+
+// updateStatsOverlay refreshes the frame timing text a few times per second, so it stays readable
+void GameManager::updateStatsOverlay(){
+    if(!Constants::SHOW_FRAME_STATS) return;
+
+    statsOverlayTimer += MetaComponents::frameTime;
+    if(statsOverlayTimer < STATS_OVERLAY_INTERVAL) return;
+    statsOverlayTimer = 0.0f;
+
+    gameScene->showFrameStats(mainWindow.getFrameStats().summary().toString() + "\n" + mainWindow.getInputLatencyStats().summary().toString());
+}
+
+/* runSimulationTicks consumes the accumulated frame time in steps of Constants::FIXED_TIME_STEP, so movement and animation 
+are the same at any frame rate. Whatever is left over becomes the interpolation alpha used when rendering */
+void GameManager::runSimulationTicks(){
+    const float step = Constants::FIXED_TIME_STEP;
+    unsigned int ticks = 0;
+
+    while (tickAccumulator >= step && ticks < MAX_TICKS_PER_FRAME) {
+        runTick();
+        tickAccumulator -= step;
+        ++ticks;
+    }
+    if (ticks == MAX_TICKS_PER_FRAME && tickAccumulator >= step) {
+        tickAccumulator = 0.0f; // too far behind; drop the backlog instead of spiralling
+    }
+    MetaComponents::interpolationAlpha = tickAccumulator / step;
+}
+
+// runTick advances the simulation by exactly one fixed step; live play and replays both go through here
+void GameManager::runTick(){
+    MetaComponents::deltaTime = Constants::FIXED_TIME_STEP;
+    MetaComponents::globalTime += Constants::FIXED_TIME_STEP;
+
+    applyInputForTick();
+    runScenesFlags();
+    resetFlags(); // one-shot inputs (mouse click) are consumed by the first tick that sees them
+}
+
+// applyInputForTick feeds this tick's input to the flags: the next queued events when playing, the recorded ones when replaying
+void GameManager::applyInputForTick(){
+    appliedInputs.clear();
+    if (replaying) {
+        replayPlayer.nextTick(appliedInputs);
+        for (const auto& event : appliedInputs) input::applyEvent(event);
+        return;
+    }
+
+    input::applyEventsForTick(inputEvents, appliedInputs);
+    recorder.recordTick(appliedInputs);
+    for (const auto& event : appliedInputs) unpresentedInputs.push_back(event.timestamp);
+}
+
+/* runReplay plays a recording back without a window. Every recorded tick runs in order, and every FRAME_LIMIT-th of a second 
+of simulated time the frame is recorded as it would be for the render thread (interpolation, raycast, draw list), so two builds
+replaying one file do the same work. The frame times are reported when it finishes */
+void GameManager::runReplay(){
+    try {
+        if (!replayPlayer.load(options.replayPath)) return;
+        const replay::Header& header = replayPlayer.getHeader();
+        if (header.configHash != Constants::CONFIG_HASH) log_warning("Recording was made with a different config.yaml; the replayed work may differ");
+        if (header.mazeSeed != Constants::MAZE_SEED) log_warning("Recording was made in a different maze; the replayed work may differ");
+
+        Constants::TICK_RATE = header.tickRate; // ticks are what was recorded, whatever the config says now
+        Constants::FIXED_TIME_STEP = 1.0f / std::max<unsigned short>(Constants::TICK_RATE, 1);
+        const unsigned int ticksPerFrame = std::max(1, static_cast<int>(std::lround(static_cast<float>(Constants::TICK_RATE) / std::max<unsigned short>(Constants::FRAME_LIMIT, 1))));
+
+        replaying = true;
+        loadScenes();
+
+        FrameSnapshot replayFrame;
+        FrameStats replayStats;
+        Timer replayTimer;
+        Timer frameTimer;
+        size_t frames = 0;
+
+        while (replayPlayer.getTicksPlayed() < header.tickCount) {
+            runTick();
+            if (replayPlayer.getTicksPlayed() % ticksPerFrame) continue;
+
+            if (!FlagSystem::flagEvents.gameEnd) {
+                MetaComponents::interpolationAlpha = 0.0f;
+                gameScene->recordFrame(replayFrame);
+            }
+            replayStats.recordPresent(frameTimer.Elapsed(), 0.0f);
+            frameTimer.Reset();
+            ++frames;
+        }
+
+        std::string report = "Replayed " + std::to_string(header.tickCount) + " ticks, " + std::to_string(frames) + " frames in " + std::to_string(replayTimer.ElapsedMillis()) + "ms\n\t" + replayStats.summary().toString() + "\n" + memory::footprintReport();
+        log_info(report);
+        std::cout << report << std::endl;
+    } catch (const std::exception& e) {
+        log_error("Exception in runReplay: " + std::string(e.what())); 
+    }
+    replaying = false;
+}
+
 void GameManager::loadScenes(){
     gameScene->createAssets();
 }
 
-// countTime counts global time and delta time for scenes to later use in runScene 
+// countTime measures the last frame and adds it to the simulation accumulator; global and delta time advance per tick 
 void GameManager::countTime() {
     sf::Time frameTime = MetaComponents::clock.restart();
-    MetaComponents::deltaTime = frameTime.asSeconds(); 
-    MetaComponents::globalTime += MetaComponents::deltaTime;
+    MetaComponents::frameTime = std::min(frameTime.asSeconds(), MAX_FRAME_TIME); 
+    tickAccumulator += MetaComponents::frameTime;
 }
 
-/* handleEventInput takes in keyboard and mouse input. It modifies flagEvents and calls setMouseClickedPos in scene to 
-pass in the position in screen where mouse was clicked */
+/* handleEventInput takes in keyboard and mouse input and queues it with the time it was polled. The simulation applies the
+queue to flagEvents tick by tick (applyInputForTick); mouse clicks are mapped into both views here, where the window is at hand */
 void GameManager::handleEventInput() {
     sf::Event event;
     while (mainWindow.getWindow().pollEvent(event)) {
+        input::Event inputEvent;
+        inputEvent.timestamp = input::Clock::now();
+
         if (event.type == sf::Event::Closed) {
             log_info("Window close event detected.");
             FlagSystem::flagEvents.gameEnd = true;
+            mainWindow.stopRenderThread(); // the render thread must let go of the window before it closes
             mainWindow.getWindow().close();
             return; 
         }
         if (event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased) {
-            bool isPressed = (event.type == sf::Event::KeyPressed); 
-            switch (event.key.code) {
-                case sf::Keyboard::A: FlagSystem::flagEvents.aPressed = isPressed; break;
-                case sf::Keyboard::S: FlagSystem::flagEvents.sPressed = isPressed; break;
-                case sf::Keyboard::W: FlagSystem::flagEvents.wPressed = isPressed; break;
-                case sf::Keyboard::D: FlagSystem::flagEvents.dPressed = isPressed; break;
-                case sf::Keyboard::B: FlagSystem::flagEvents.bPressed = isPressed; break;
-                case sf::Keyboard::M: FlagSystem::flagEvents.mPressed = isPressed; break;
-                case sf::Keyboard::Space: FlagSystem::flagEvents.spacePressed = isPressed; break;
-                default: break;
-            }
+            if (!input::keyFromSfml(event.key.code, inputEvent.key)) continue;
+            inputEvent.type = (event.type == sf::Event::KeyPressed) ? input::EventType::KeyPressed : input::EventType::KeyReleased; 
+            if (!inputEvents.push(inputEvent)) log_warning("Input queue full, key event dropped");
         }
         if (event.type == sf::Event::MouseButtonPressed) {
-            FlagSystem::flagEvents.mouseClicked = true;
-            sf::Vector2f worldPos = mainWindow.getWindow().mapPixelToCoords(sf::Mouse::getPosition(mainWindow.getWindow()), MetaComponents::bigView);
-            MetaComponents::bigViewmouseClickedPosition_i = static_cast<sf::Vector2i>(worldPos);
-            MetaComponents::bigViewmouseClickedPosition_f = worldPos; 
-            //std::cout << "mouse clicked in big view x: " <<  MetaComponents::bigViewmouseClickedPosition_i.x << " and big view y: " <<  MetaComponents::bigViewmouseClickedPosition_i.y <<std::endl;
-
-            worldPos = mainWindow.getWindow().mapPixelToCoords(sf::Mouse::getPosition(mainWindow.getWindow()), MetaComponents::smallView);
-            MetaComponents::smallViewmouseClickedPosition_i = static_cast<sf::Vector2i>(worldPos);
-            MetaComponents::smallViewmouseClickedPosition_f = worldPos; 
-            //std::cout << "mouse clicked in small view x: " <<  MetaComponents::smallViewmouseClickedPosition_i.x << " and small view y: " <<  MetaComponents::smallViewmouseClickedPosition_i.y <<std::endl;
+            inputEvent.type = input::EventType::MouseClicked;
+            inputEvent.bigViewPosition = mainWindow.getWindow().mapPixelToCoords(sf::Mouse::getPosition(mainWindow.getWindow()), MetaComponents::bigView);
+            inputEvent.smallViewPosition = mainWindow.getWindow().mapPixelToCoords(sf::Mouse::getPosition(mainWindow.getWindow()), MetaComponents::smallView);
+            if (!inputEvents.push(inputEvent)) log_warning("Input queue full, mouse click dropped");
         }
     }
 }
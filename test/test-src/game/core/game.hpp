@@ -13,20 +13,49 @@
 #include <SFML/Graphics.hpp>
 
 #include "../scenes/scenes.hpp"
+#include "input.hpp"
+#include "replay.hpp"
 
 class GameManager {
 public:
-    GameManager();
+    struct RunOptions {
+        std::filesystem::path recordPath; // record the session's per-tick input here
+        std::filesystem::path replayPath; // replay this recording headless instead of playing
+    };
+
+    GameManager(const RunOptions& runOptions = {});
     void loadScenes(); 
     void runGame();
     void runScenesFlags();
+    void renderScenes(); 
     void resetFlags(); 
     
 private:
     void countTime(); // countTime counts time regardless of the scene 
+    void runSimulationTicks(); // runs as many fixed-size ticks as the accumulated frame time allows
+    void updateStatsOverlay(); 
+    void applyInputForTick(); 
+    void runTick(); 
+    void runReplay(); // headless: every recorded tick, plus the CPU side of a frame at the configured frame rate
     void handleEventInput(); // handleEventInput taks input from device, such as keyboard, mouse, etc */
 
+    static constexpr unsigned int MAX_TICKS_PER_FRAME = 8; // catch-up limit before the backlog is dropped
+    static constexpr float MAX_FRAME_TIME = 0.25f; // seconds; longer stalls (window drag, debugger) are clamped
+    static constexpr float STATS_OVERLAY_INTERVAL = 0.5f; // seconds between overlay refreshes
+
+    FrameSnapshotBuffer frameSnapshots; // handed to the render thread in pipelined mode; declared first so it outlives that thread
     GameWindow mainWindow;
+    float tickAccumulator{};
+    float statsOverlayTimer{};
+
+    RunOptions options;
+    replay::Recorder recorder;
+    replay::Player replayPlayer;
+    bool replaying = false;
+
+    input::EventQueue inputEvents; // polled, not yet applied to any tick
+    std::vector<input::Event> appliedInputs; // applied by the current tick
+    std::vector<input::Clock::time_point> unpresentedInputs; // applied, waiting for the first frame that shows them
 
     std::unique_ptr<gamePlayScene> gameScene;
 };
@@ -0,0 +1,91 @@
+//
+//  input.cpp
+//  sfml game template
+//
+//
+
+#include "input.hpp"
+
+namespace input {
+
+    bool keyFromSfml(sf::Keyboard::Key sfmlKey, Key& key) {
+        switch (sfmlKey) {
+            case sf::Keyboard::W: key = Key::W; return true;
+            case sf::Keyboard::A: key = Key::A; return true;
+            case sf::Keyboard::S: key = Key::S; return true;
+            case sf::Keyboard::D: key = Key::D; return true;
+            case sf::Keyboard::B: key = Key::B; return true;
+            case sf::Keyboard::M: key = Key::M; return true;
+            case sf::Keyboard::Space: key = Key::Space; return true;
+            default: return false;
+        }
+    }
+
+    bool EventQueue::push(const Event& event) {
+        if (count == CAPACITY) return false;
+        events[(head + count) % CAPACITY] = event;
+        ++count;
+        return true;
+    }
+
+    void EventQueue::pop() {
+        if (count == 0) return;
+        head = (head + 1) % CAPACITY;
+        --count;
+    }
+
+    namespace {
+        bool* keyFlag(Key key) {
+            switch (key) {
+                case Key::W: return &FlagSystem::flagEvents.wPressed;
+                case Key::A: return &FlagSystem::flagEvents.aPressed;
+                case Key::S: return &FlagSystem::flagEvents.sPressed;
+                case Key::D: return &FlagSystem::flagEvents.dPressed;
+                case Key::B: return &FlagSystem::flagEvents.bPressed;
+                case Key::M: return &FlagSystem::flagEvents.mPressed;
+                case Key::Space: return &FlagSystem::flagEvents.spacePressed;
+                default: return nullptr;
+            }
+        }
+    }
+
+    void applyEvent(const Event& event) {
+        if (event.type == EventType::MouseClicked) {
+            FlagSystem::flagEvents.mouseClicked = true;
+            MetaComponents::bigViewmouseClickedPosition_f = event.bigViewPosition;
+            MetaComponents::bigViewmouseClickedPosition_i = static_cast<sf::Vector2i>(event.bigViewPosition);
+            MetaComponents::smallViewmouseClickedPosition_f = event.smallViewPosition;
+            MetaComponents::smallViewmouseClickedPosition_i = static_cast<sf::Vector2i>(event.smallViewPosition);
+            return;
+        }
+        if (bool* flag = keyFlag(event.key)) *flag = (event.type == EventType::KeyPressed);
+    }
+
+    size_t applyEventsForTick(EventQueue& queue, std::vector<Event>& applied) {
+        std::array<bool, static_cast<size_t>(Key::Count)> keyChanged {};
+        bool clicked = false;
+        size_t appliedCount = 0;
+
+        while (!queue.empty()) {
+            const Event& event = queue.front();
+            if (event.type == EventType::MouseClicked) {
+                if (clicked) break; // mouseClicked is one-shot per tick; the second click goes to the next one
+                clicked = true;
+            } else {
+                bool* flag = keyFlag(event.key);
+                if (!flag) { queue.pop(); continue; }
+                bool pressed = (event.type == EventType::KeyPressed);
+                if (*flag == pressed) { queue.pop(); continue; } // key repeat, nothing changes
+                size_t keyIndex = static_cast<size_t>(event.key);
+                if (keyChanged[keyIndex]) break; // would undo this tick's change before anything saw it
+                keyChanged[keyIndex] = true;
+            }
+
+            applyEvent(event);
+            applied.push_back(event);
+            queue.pop();
+            ++appliedCount;
+        }
+        return appliedCount;
+    }
+}
@@ -0,0 +1,57 @@
+//
+//  input.hpp
+//  sfml game template
+//
+//
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include "../globals/globals.hpp"
+
+/* input namespace turns window events into a timestamped queue that the simulation drains in order, one tick at a time.
+Every press and release reaches at least one tick, even when both arrive within a single frame */
+namespace input {
+    using Clock = std::chrono::steady_clock;
+
+    enum class Key : std::uint8_t { W, A, S, D, B, M, Space, Count };
+    enum class EventType : std::uint8_t { KeyPressed, KeyReleased, MouseClicked };
+
+    struct Event {
+        EventType type = EventType::KeyPressed;
+        Key key = Key::Count; // unused for mouse clicks
+        sf::Vector2f bigViewPosition {}; // mouse clicks, already mapped into each view when polled
+        sf::Vector2f smallViewPosition {};
+        Clock::time_point timestamp {};
+    };
+
+    bool keyFromSfml(sf::Keyboard::Key sfmlKey, Key& key); // false for keys the game does not use
+
+    // fixed-capacity ring buffer; the window thread pushes while polling, the simulation pops per tick
+    class EventQueue {
+    public:
+        static constexpr size_t CAPACITY = 256;
+
+        bool push(const Event& event); // false (event dropped) when full
+        const Event& front() const { return events[head]; }
+        void pop();
+        bool empty() const { return count == 0; }
+        size_t size() const { return count; }
+
+    private:
+        std::array<Event, CAPACITY> events {};
+        size_t head = 0;
+        size_t count = 0;
+    };
+
+    void applyEvent(const Event& event); // writes FlagSystem::flagEvents and the clicked positions in MetaComponents
+
+    /* applies queued events in order for one simulation tick, stopping before one that would undo a change this tick already
+    made (a release of a key pressed this tick, or a second click). Applied events are appended to applied */
+    size_t applyEventsForTick(EventQueue& queue, std::vector<Event>& applied);
+}
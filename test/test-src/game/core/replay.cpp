@@ -0,0 +1,164 @@
+//
+//  replay.cpp
+//  sfml game template
+//
+//
+
+#include "replay.hpp"
+
+namespace replay {
+
+    namespace {
+        constexpr std::uint32_t RECORDING_MAGIC = 0x4352'5a4d; // "MZRC"
+        constexpr std::uint16_t RECORDING_VERSION = 1;
+        constexpr std::uint8_t IDLE_RUN_BIT = 0x80;
+        constexpr std::uint8_t MAX_IDLE_RUN = 0x7f;
+
+        template<typename T> void writeValue(std::ofstream& out, const T& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+        template<typename T> bool readValue(std::ifstream& in, T& value) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T))); }
+
+        void appendFloat(std::vector<std::uint8_t>& bytes, float value) {
+            const auto* raw = reinterpret_cast<const std::uint8_t*>(&value);
+            bytes.insert(bytes.end(), raw, raw + sizeof(float));
+        }
+
+        bool takeFloat(const std::vector<std::uint8_t>& bytes, size_t& cursor, float& value) {
+            if (cursor + sizeof(float) > bytes.size()) return false;
+            std::memcpy(&value, bytes.data() + cursor, sizeof(float));
+            cursor += sizeof(float);
+            return true;
+        }
+
+        // fields one at a time so the layout does not depend on struct padding
+        bool readHeaderFields(std::ifstream& in, Header& header) {
+            return readValue(in, header.magic) && readValue(in, header.version) && readValue(in, header.tickRate) &&
+                   readValue(in, header.mazeSeed) && readValue(in, header.configHash) && readValue(in, header.tickCount);
+        }
+    }
+
+    bool readHeader(const std::filesystem::path& path, Header& header) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open() || !readHeaderFields(in, header)) {
+            log_error("Failed to read recording: " + path.string());
+            return false;
+        }
+        if (header.magic != RECORDING_MAGIC || header.version != RECORDING_VERSION) {
+            log_error("Not a recording, or recorded by an incompatible version: " + path.string());
+            return false;
+        }
+        return true;
+    }
+
+// Recorder
+    void Recorder::begin(const std::filesystem::path& filePath, std::uint16_t tickRate, std::uint32_t mazeSeed, std::uint64_t configHash) {
+        path = filePath;
+        header = Header{ RECORDING_MAGIC, RECORDING_VERSION, tickRate, mazeSeed, configHash, 0 };
+        ticks.clear();
+        idleRun = 0;
+        recording = true;
+        log_info("Recording input to " + path.string());
+    }
+
+    void Recorder::recordTick(const std::vector<input::Event>& events) {
+        if (!recording) return;
+        ++header.tickCount;
+
+        if (events.empty()) {
+            if (++idleRun == MAX_IDLE_RUN) flushIdleRun();
+            return;
+        }
+        flushIdleRun();
+
+        ticks.push_back(static_cast<std::uint8_t>(std::min<size_t>(events.size(), MAX_IDLE_RUN)));
+        for (size_t i = 0; i < events.size() && i < MAX_IDLE_RUN; ++i) {
+            const auto& event = events[i];
+            ticks.push_back(static_cast<std::uint8_t>(static_cast<std::uint8_t>(event.type) << 4 | static_cast<std::uint8_t>(event.key)));
+            if (event.type == input::EventType::MouseClicked) {
+                appendFloat(ticks, event.bigViewPosition.x);
+                appendFloat(ticks, event.bigViewPosition.y);
+                appendFloat(ticks, event.smallViewPosition.x);
+                appendFloat(ticks, event.smallViewPosition.y);
+            }
+        }
+    }
+
+    void Recorder::flushIdleRun() {
+        if (!idleRun) return;
+        ticks.push_back(IDLE_RUN_BIT | idleRun);
+        idleRun = 0;
+    }
+
+    bool Recorder::finish() {
+        if (!recording) return false;
+        recording = false;
+        flushIdleRun();
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            log_error("Failed to write recording: " + path.string());
+            return false;
+        }
+        writeValue(out, header.magic);
+        writeValue(out, header.version);
+        writeValue(out, header.tickRate);
+        writeValue(out, header.mazeSeed);
+        writeValue(out, header.configHash);
+        writeValue(out, header.tickCount);
+        out.write(reinterpret_cast<const char*>(ticks.data()), static_cast<std::streamsize>(ticks.size()));
+
+        log_info("Recorded " + std::to_string(header.tickCount) + " ticks (" + std::to_string(ticks.size()) + " bytes of input) to " + path.string());
+        return static_cast<bool>(out);
+    }
+
+// Player
+    bool Player::load(const std::filesystem::path& path) {
+        if (!readHeader(path, header)) return false;
+
+        std::ifstream in(path, std::ios::binary);
+        Header skipped;
+        readHeaderFields(in, skipped);
+        ticks.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+        cursor = 0;
+        idleRemaining = 0;
+        ticksPlayed = 0;
+        log_info("Loaded recording of " + std::to_string(header.tickCount) + " ticks from " + path.string());
+        return true;
+    }
+
+    bool Player::nextTick(std::vector<input::Event>& events) {
+        events.clear();
+        if (ticksPlayed >= header.tickCount) return false;
+        ++ticksPlayed;
+
+        if (idleRemaining) {
+            --idleRemaining;
+            return true;
+        }
+        if (cursor >= ticks.size()) return true; // idle tail
+
+        std::uint8_t entry = ticks[cursor++];
+        if (entry & IDLE_RUN_BIT) {
+            idleRemaining = static_cast<std::uint8_t>((entry & MAX_IDLE_RUN) - 1);
+            return true;
+        }
+
+        for (std::uint8_t i = 0; i < entry && cursor < ticks.size(); ++i) {
+            input::Event event;
+            std::uint8_t packed = ticks[cursor++];
+            event.type = static_cast<input::EventType>(packed >> 4);
+            event.key = static_cast<input::Key>(packed & 0x0f);
+            if (event.type == input::EventType::MouseClicked) {
+                bool complete = takeFloat(ticks, cursor, event.bigViewPosition.x) && takeFloat(ticks, cursor, event.bigViewPosition.y) &&
+                                takeFloat(ticks, cursor, event.smallViewPosition.x) && takeFloat(ticks, cursor, event.smallViewPosition.y);
+                if (!complete) {
+                    log_error("Recording is truncated");
+                    ticksPlayed = header.tickCount;
+                    return false;
+                }
+            }
+            events.push_back(event);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,69 @@
+//
+//  replay.hpp
+//  sfml game template
+//
+//
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#include "input.hpp"
+
+/* replay namespace records the input each simulation tick applied, along with everything else the simulation depends on (maze
+seed, config hash, tick rate), and plays it back tick for tick. A replayed session does exactly the same simulation work as the
+recorded one, so two builds replaying the same file can be compared on timing alone.
+
+File layout: Header, then one entry per tick. An entry is a count byte with the event records that follow it; runs of ticks
+without input collapse into one byte (IDLE_RUN_BIT | run length). An event record is a byte of (type << 4 | key), followed by
+the four click coordinates for mouse clicks */
+namespace replay {
+
+    struct Header {
+        std::uint32_t magic = 0;
+        std::uint16_t version = 0;
+        std::uint16_t tickRate = 0;
+        std::uint32_t mazeSeed = 0;
+        std::uint64_t configHash = 0;
+        std::uint32_t tickCount = 0;
+    };
+
+    bool readHeader(const std::filesystem::path& path, Header& header);
+
+    class Recorder {
+    public:
+        void begin(const std::filesystem::path& path, std::uint16_t tickRate, std::uint32_t mazeSeed, std::uint64_t configHash);
+        void recordTick(const std::vector<input::Event>& events);
+        bool finish(); // writes the file; false when it could not be written
+        bool isRecording() const { return recording; }
+        ~Recorder() { if (recording) finish(); }
+
+    private:
+        void flushIdleRun();
+
+        std::filesystem::path path;
+        Header header;
+        std::vector<std::uint8_t> ticks; // encoded tick entries, written out by finish()
+        std::uint8_t idleRun = 0;
+        bool recording = false;
+    };
+
+    class Player {
+    public:
+        bool load(const std::filesystem::path& path);
+        bool nextTick(std::vector<input::Event>& events); // false once every recorded tick has been played
+        const Header& getHeader() const { return header; }
+        std::uint32_t getTicksPlayed() const { return ticksPlayed; }
+
+    private:
+        Header header;
+        std::vector<std::uint8_t> ticks;
+        size_t cursor = 0;
+        std::uint8_t idleRemaining = 0;
+        std::uint32_t ticksPlayed = 0;
+    };
+}
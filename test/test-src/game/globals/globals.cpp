@@ -4,6 +4,8 @@
 //
 
 #include "globals.hpp"  
+#include "../navigation/corridorGraph.hpp"
+#include "../jobs/jobs.hpp"
     
 namespace MetaComponents {
     sf::Clock clock;
@@ -106,10 +108,15 @@ namespace Constants {
         return sf::Vector2f{ xPos, yPos };
     }
 
-    void initialize(){
-        std::srand(static_cast<unsigned int>(std::time(nullptr))); 
-
+    void initialize(std::uint32_t mazeSeed){
         readFromYaml(std::filesystem::path("test/test-src/game/globals/config.yaml"));
+
+        // one seed drives every random choice, so a maze (and a recorded session in it) can be reproduced
+        MAZE_SEED = mazeSeed ? mazeSeed : static_cast<std::uint32_t>(TILEMAP_SEED);
+        if (!MAZE_SEED) MAZE_SEED = std::random_device{}() | 1u;
+        std::srand(MAZE_SEED); 
+        log_info("Maze seed: " + std::to_string(MAZE_SEED));
+
         writeRandomTileMap(std::filesystem::path("test/test-assets/tiles/tilemap.txt"), DFSmazeGenerator);
         generateTilePathInstruction(std::filesystem::path("test/test-assets/tiles/tilemap.txt"), AstarPathInstructionGenerator);
 
@@ -117,160 +124,359 @@ namespace Constants {
         makeRectsAndBitmasks(); 
     }
 
+    // Declarative config schema. Each entry maps a dotted yaml key to the variable it fills; the type comes from
+    // the variable and the last argument is the value used when the key is missing or invalid. The yaml loader,
+    // the snapshot writer and the snapshot reader are all generated from this one table.
+    const std::vector<ConfigField>& configSchema() {
+        static const std::vector<ConfigField> schema = {
+            // Game display settings
+            configField("world.scale", WORLD_SCALE, 1.0f),
+            configField("world.width", WORLD_WIDTH, 608),
+            configField("world.height", WORLD_HEIGHT, 416),
+            configField("world.frame_limit", FRAME_LIMIT, 60),
+            configField("world.tick_rate", TICK_RATE, 120),
+            configField("world.pipelined_rendering", PIPELINED_RENDERING, false),
+            configField("world.vsync", VSYNC, false),
+            configField("world.adaptive_pacing", ADAPTIVE_PACING, true),
+            configField("world.show_frame_stats", SHOW_FRAME_STATS, false),
+            configField("world.title", GAME_TITLE, "maze 3D"),
+            configField("world.view.size_x", VIEW_SIZE_X, 608.0f),
+            configField("world.view.size_y", VIEW_SIZE_Y, 416.0f),
+            configField("world.view.initial_center", VIEW_INITIAL_CENTER, {}),
+            configField("world.FOV", FOV, 60),
+            configField("world.rays_num", RAYS_NUM, 200),
+            configField("world.ground_color", GROUND_COLOR, sf::Color::Black),
+
+            // Score settings
+            configField("score.initial", INITIAL_SCORE, 0),
+
+            // Animation settings
+            configField("animation.change_time", ANIMATION_CHANGE_TIME, 0.1f),
+            configField("animation.passthrough_offset", PASSTHROUGH_OFFSET, 0),
+
+            // Sprite and text settings
+            configField("sprite.out_of_bounds_offset", SPRITE_OUT_OF_BOUNDS_OFFSET, 0),
+            configField("sprite.out_of_bounds_adjustment", SPRITE_OUT_OF_BOUNDS_ADJUSTMENT, 0),
+            configField("sprite.player_y_pos_bounds_run", PLAYER_Y_POS_BOUNDS_RUN, 0),
+
+            // Player paths and settings
+            configField("sprites.sprite1.path", SPRITE1_PATH, {}),
+            configField("sprites.sprite1.speed", SPRITE1_SPEED, 0.0f),
+            configField("sprites.sprite1.turn_speed", SPRITE1_TURN_SPEED, 60.0f),
+            configField("sprites.sprite1.acceleration", SPRITE1_ACCELERATION, {1.0f, 1.0f}),
+            configField("sprites.sprite1.jump_acceleration", SPRITE1_JUMP_ACCELERATION, {1.0f, 1.0f}),
+            configField("sprites.sprite1.index_max", SPRITE1_INDEXMAX, 1),
+            configField("sprites.sprite1.animation_rows", SPRITE1_ANIMATIONROWS, 1),
+            configField("sprites.sprite1.position", SPRITE1_POSITION, {}),
+            configField("sprites.sprite1.scale", SPRITE1_SCALE, {1.0f, 1.0f}),
+
+            // Enemy paths and settings
+            configField("sprites.button1.path", BUTTON1_PATH, {}),
+            configField("sprites.button1.index_max", BUTTON1_INDEXMAX, 1),
+            configField("sprites.button1.animation_rows", BUTTON1_ANIMATIONROWS, 1),
+            configField("sprites.button1.position", BUTTON1_POSITION, {}),
+            configField("sprites.button1.scale", BUTTON1_SCALE, {1.0f, 1.0f}),
+
+            // Bullet paths and settings
+            configField("sprites.bullet.path", BULLET_PATH, {}),
+            configField("sprites.bullet.speed", BULLET_INITIALSPEED, 0.0f),
+            configField("sprites.bullet.acceleration", BULLET_ACCELERATION, {1.0f, 1.0f}),
+            configField("sprites.bullet.index_max", BULLET_INDEXMAX, 1),
+            configField("sprites.bullet.animation_rows", BULLET_ANIMATIONROWS, 1),
+            configField("sprites.bullet.position", BULLET_STARTINGPOS, {}),
+            configField("sprites.bullet.scale", BULLET_STARTINGSCALE, {1.0f, 1.0f}),
+
+            // Frame paths and settings
+            configField("sprites.frame.path", FRAME_PATH, {}),
+            configField("sprites.frame.position", FRAME_POSITION, {}),
+            configField("sprites.frame.scale", FRAME_SCALE, {1.0f, 1.0f}),
+
+            // Background (in the big screen) settings
+            configField("sprites.background_big.path", BACKGROUNDBIG_PATH, {}),
+            configField("sprites.background_big.position", BACKGROUNDBIG_POSITION, {}),
+            configField("sprites.background_big.scale", BACKGROUNDBIG_SCALE, {1.0f, 1.0f}),
+            configField("sprites.background_big_final.path", BACKGROUNDBIGFINAL_PATH, {}),
+            configField("sprites.background_big_final.position", BACKGROUNDBIGFINAL_POSITION, {}),
+            configField("sprites.background_big_final.scale", BACKGROUNDBIGFINAL_SCALE, {1.0f, 1.0f}),
+            configField("sprites.background_big_start.path", BACKGROUNDBIGSTART_PATH, {}),
+            configField("sprites.background_big_start.position", BACKGROUNDBIGSTART_POSITION, {}),
+            configField("sprites.background_big_start.scale", BACKGROUNDBIGSTART_SCALE, {1.0f, 1.0f}),
+
+            // Tile settings
+            configField("tiles.path", TILES_PATH, {}),
+            configField("tiles.rows", TILES_ROWS, 0),
+            configField("tiles.columns", TILES_COLUMNS, 0),
+            configField("tiles.number", TILES_NUM, TILES_NUMBER),
+            configField("tiles.scale", TILES_SCALE, {1.0f, 1.0f}),
+            configField("tiles.tile_width", TILE_WIDTH, 32),
+            configField("tiles.tile_height", TILE_HEIGHT, 32),
+            configField("tiles.starting_index", TILE_STARTINGINDEX, 0),
+            configField("tiles.ending_index", TILE_ENDINGINDEX, 0),
+            configField("tiles.walkable_index", TILE_WALKABLEINDEX, 0),
+            configField("tiles.wall_index", TILE_WALLINDEX, 0),
+
+            // Tilemap settings
+            configField("tilemap.position", TILEMAP_POSITION, {}),
+            configField("tilemap.width", TILEMAP_WIDTH, 19),
+            configField("tilemap.height", TILEMAP_HEIGHT, 13),
+            configField("tilemap.boundary_offset", TILEMAP_BOUNDARYOFFSET, 0.0f),
+            configField("tilemap.filepath", TILEMAP_FILEPATH, {}),
+            configField("tilemap.playerspawn_index", TILEMAP_PLAYERSPAWNINDEX, 0),
+            configField("tilemap.goal_index", TILEMAP_GOALINDEX, 0),
+            configField("tilemap.seed", TILEMAP_SEED, 0),
+
+            // Text settings
+            configField("text.size", TEXT_SIZE, 20),
+            configField("text.font_path", TEXT_PATH, {}),
+            configField("text.message", TEXT_MESSAGE, ""),
+            configField("text.position", TEXT_POSITION, {}),
+            configField("text.color", TEXT_COLOR, sf::Color::White),
+            configField("score_text.size", SCORETEXT_SIZE, 20),
+            configField("score_text.message", SCORETEXT_MESSAGE, ""),
+            configField("score_text.position", SCORETEXT_POSITION, {}),
+            configField("score_text.color", SCORETEXT_COLOR, sf::Color::White),
+            configField("ending_text.size", ENDINGTEXT_SIZE, 20),
+            configField("ending_text.message", ENDINGTEXT_MESSAGE, ""),
+            configField("ending_text.position", ENDINGTEXT_POSITION, {}),
+            configField("ending_text.color", ENDINGTEXT_COLOR, sf::Color::White),
+            configField("stats_text.size", STATSTEXT_SIZE, 14),
+            configField("stats_text.position", STATSTEXT_POSITION, {}),
+            configField("stats_text.color", STATSTEXT_COLOR, sf::Color::Green),
+
+            // Music settings
+            configField("music.background_music.path", BACKGROUNDMUSIC_PATH, {}),
+            configField("music.background_music.volume", BACKGROUNDMUSIC_VOLUME, 100.0f),
+            configField("music.background_music.loop", BACKGROUNDMUSIC_LOOP, true),
+            configField("music.background_music.ending_volume", BACKGROUNDMUSIC_ENDINGVOLUME, 100.0f),
+
+            // Sound settings
+            configField("sound.button_click.path", BUTTONCLICKSOUND_PATH, {}),
+            configField("sound.button_click.volume", BUTTONCLICKSOUND_VOLUME, 100.0f),
+        };
+        return schema;
+    }
+
+    namespace {
+        constexpr std::uint32_t CONFIG_SNAPSHOT_MAGIC = 0x4643'5a4d; // "MZCF"
+        constexpr std::uint32_t CONFIG_SNAPSHOT_VERSION = 1;
+
+        std::uint64_t fnv1a(const void* data, size_t size, std::uint64_t hash = 14695981039346656037ull) {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        // hash of the key names and types, so adding or retyping a field invalidates old snapshots
+        std::uint64_t schemaFingerprint() {
+            std::uint64_t hash = fnv1a(&CONFIG_SNAPSHOT_VERSION, sizeof(CONFIG_SNAPSHOT_VERSION));
+            for (const auto& field : configSchema()) {
+                size_t type = field.target.index();
+                hash = fnv1a(field.key.data(), field.key.size(), hash);
+                hash = fnv1a(&type, sizeof(type), hash);
+            }
+            return hash;
+        }
+
+        // resolves dotted keys against the yaml tree; the parent of the previous lookup is kept because schema entries are grouped
+        class ConfigNodeCursor {
+        public:
+            explicit ConfigNodeCursor(const YAML::Node& root) : root(root) {}
+
+            YAML::Node find(std::string_view key) {
+                size_t lastDot = key.rfind('.');
+                std::string_view parentPath = lastDot == std::string_view::npos ? std::string_view{} : key.substr(0, lastDot);
+                std::string leaf(lastDot == std::string_view::npos ? key : key.substr(lastDot + 1));
+
+                if (!resolved || parentPath != parentKey) resolveParent(parentPath);
+                if (!parentFound) return YAML::Node(YAML::NodeType::Undefined);
+                return std::as_const(parent)[leaf];
+            }
+
+        private:
+            void resolveParent(std::string_view parentPath) {
+                resolved = true;
+                parentKey = std::string(parentPath);
+                parentFound = true;
+                YAML::Node node = root;
+
+                size_t begin = 0;
+                while (begin < parentPath.size()) {
+                    size_t end = parentPath.find('.', begin);
+                    if (end == std::string_view::npos) end = parentPath.size();
+                    YAML::Node child = std::as_const(node)[std::string(parentPath.substr(begin, end - begin))];
+                    if (!child.IsDefined() || !child.IsMap()) {
+                        parentFound = false;
+                        return;
+                    }
+                    node.reset(child); // reset rebinds; operator= would overwrite the node's contents
+                    begin = end + 1;
+                }
+                parent.reset(node);
+            }
+
+            const YAML::Node& root;
+            std::string parentKey;
+            YAML::Node parent;
+            bool resolved = false;
+            bool parentFound = false;
+        };
+
+        template<typename T> T decodeConfigValue(const YAML::Node& node) {
+            if constexpr (std::is_same_v<T, std::filesystem::path>) {
+                return node.as<std::string>();
+            } else if constexpr (std::is_same_v<T, sf::Vector2f>) {
+                if (!node.IsMap() || !node["x"] || !node["y"]) throw std::runtime_error("expected a map with x and y");
+                return { node["x"].as<float>(), node["y"].as<float>() };
+            } else if constexpr (std::is_same_v<T, sf::Color>) {
+                std::string name = node.as<std::string>();
+                if (SpriteComponents::toSfColor(name) == sf::Color::Black && name != "BLACK") throw std::runtime_error("unknown color \"" + name + "\"");
+                return SpriteComponents::toSfColor(name);
+            } else {
+                return node.as<T>();
+            }
+        }
+
+        template<typename T> void writeSnapshotValue(std::ofstream& out, const T& value) {
+            if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::filesystem::path>) {
+                std::string text = value;
+                std::uint32_t length = static_cast<std::uint32_t>(text.size());
+                out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+                out.write(text.data(), length);
+            } else if constexpr (std::is_same_v<T, sf::Color>) {
+                const sf::Uint8 rgba[4] = { value.r, value.g, value.b, value.a };
+                out.write(reinterpret_cast<const char*>(rgba), sizeof(rgba));
+            } else if constexpr (std::is_same_v<T, sf::Vector2f>) {
+                out.write(reinterpret_cast<const char*>(&value.x), sizeof(float));
+                out.write(reinterpret_cast<const char*>(&value.y), sizeof(float));
+            } else {
+                out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+        }
+
+        template<typename T> bool readSnapshotValue(std::ifstream& in, T& value) {
+            if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::filesystem::path>) {
+                std::uint32_t length = 0;
+                if (!in.read(reinterpret_cast<char*>(&length), sizeof(length))) return false;
+                std::string text(length, '\0');
+                if (!in.read(text.data(), length)) return false;
+                value = text;
+            } else if constexpr (std::is_same_v<T, sf::Color>) {
+                sf::Uint8 rgba[4];
+                if (!in.read(reinterpret_cast<char*>(rgba), sizeof(rgba))) return false;
+                value = sf::Color(rgba[0], rgba[1], rgba[2], rgba[3]);
+            } else if constexpr (std::is_same_v<T, sf::Vector2f>) {
+                if (!in.read(reinterpret_cast<char*>(&value.x), sizeof(float))) return false;
+                if (!in.read(reinterpret_cast<char*>(&value.y), sizeof(float))) return false;
+            } else {
+                if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) return false;
+            }
+            return true;
+        }
+
+        bool readConfigSnapshot(const std::filesystem::path& snapshotPath, std::uint64_t yamlHash) {
+            std::ifstream in(snapshotPath, std::ios::binary);
+            if (!in.is_open()) return false;
+
+            std::uint32_t magic = 0, version = 0;
+            std::uint64_t fingerprint = 0, hash = 0;
+            in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+            in.read(reinterpret_cast<char*>(&version), sizeof(version));
+            in.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint));
+            in.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+            if (!in || magic != CONFIG_SNAPSHOT_MAGIC || version != CONFIG_SNAPSHOT_VERSION || fingerprint != schemaFingerprint() || hash != yamlHash) return false;
+
+            for (const auto& field : configSchema()) {
+                bool ok = std::visit([&in](auto* target) { return readSnapshotValue(in, *target); }, field.target);
+                if (!ok) return false;
+            }
+            return true;
+        }
+
+        void writeConfigSnapshot(const std::filesystem::path& snapshotPath, std::uint64_t yamlHash) {
+            std::ofstream out(snapshotPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                log_warning("Unable to write config snapshot: " + snapshotPath.string());
+                return;
+            }
+            std::uint64_t fingerprint = schemaFingerprint();
+            out.write(reinterpret_cast<const char*>(&CONFIG_SNAPSHOT_MAGIC), sizeof(CONFIG_SNAPSHOT_MAGIC));
+            out.write(reinterpret_cast<const char*>(&CONFIG_SNAPSHOT_VERSION), sizeof(CONFIG_SNAPSHOT_VERSION));
+            out.write(reinterpret_cast<const char*>(&fingerprint), sizeof(fingerprint));
+            out.write(reinterpret_cast<const char*>(&yamlHash), sizeof(yamlHash));
+
+            for (const auto& field : configSchema()) {
+                std::visit([&out](auto* target) { writeSnapshotValue(out, *target); }, field.target);
+            }
+        }
+    }
+
+    // fills every schema field from the yaml tree, collecting all problems instead of stopping at the first one
+    std::vector<std::string> loadConfigFields(const YAML::Node& config) {
+        std::vector<std::string> errors;
+        ConfigNodeCursor cursor(config);
+
+        for (const auto& field : configSchema()) {
+            std::visit([&](auto* target) {
+                using T = std::remove_pointer_t<decltype(target)>;
+                const T& fallback = std::get<T>(field.fallback);
+                try {
+                    YAML::Node node = cursor.find(field.key);
+                    if (!node) {
+                        errors.emplace_back(std::string(field.key) + ": missing");
+                        *target = fallback;
+                        return;
+                    }
+                    *target = decodeConfigValue<T>(node);
+                } catch (const std::exception& e) {
+                    errors.emplace_back(std::string(field.key) + ": " + e.what());
+                    *target = fallback;
+                }
+            }, field.target);
+        }
+        return errors;
+    }
+
+    // values computed from other fields; run after both the yaml and the snapshot path
+    void deriveConfigValues() {
+        VIEW_RECT = { 0.0f, 0.0f, VIEW_SIZE_X, VIEW_SIZE_Y };
+        FIXED_TIME_STEP = 1.0f / std::max<unsigned short>(TICK_RATE, 1);
+        for (unsigned short i = 0; i < TILES_NUMBER; ++i) {
+            TILES_BOOLS[i] = i < TILES_NUM && (i == TILE_STARTINGINDEX || i == TILE_ENDINGINDEX || i == TILE_WALKABLEINDEX);
+        }
+    }
+
     void readFromYaml(const std::filesystem::path configFile) {
         try{ 
-            YAML::Node config = YAML::LoadFile(configFile);
-
-            // Load game display settings
-            WORLD_SCALE = config["world"]["scale"].as<float>();
-            WORLD_WIDTH = config["world"]["width"].as<unsigned short>();
-            WORLD_HEIGHT = config["world"]["height"].as<unsigned short>();
-            FRAME_LIMIT = config["world"]["frame_limit"].as<unsigned short>();
-            GAME_TITLE = config["world"]["title"].as<std::string>();
-            VIEW_SIZE_X = config["world"]["view"]["size_x"].as<float>();
-            VIEW_SIZE_Y = config["world"]["view"]["size_y"].as<float>();
-            VIEW_INITIAL_CENTER = {config["world"]["view"]["initial_center"]["x"].as<float>(),
-                                config["world"]["view"]["initial_center"]["y"].as<float>()};
-            VIEW_RECT = { 0.0f, 0.0f, VIEW_SIZE_X, VIEW_SIZE_Y };
-            FOV = config["world"]["FOV"].as<unsigned short>(); 
-            RAYS_NUM = config["world"]["rays_num"].as<size_t>(); 
-            GROUND_COLOR = SpriteComponents::toSfColor(config["world"]["ground_color"].as<std::string>());
-
-            // Load score settings
-            INITIAL_SCORE = config["score"]["initial"].as<unsigned short>(); 
-
-            // Load animation settings
-            ANIMATION_CHANGE_TIME = config["animation"]["change_time"].as<float>();
-            PASSTHROUGH_OFFSET = config["animation"]["passthrough_offset"].as<short>();
-
-            // Load sprite and text settings
-            SPRITE_OUT_OF_BOUNDS_OFFSET = config["sprite"]["out_of_bounds_offset"].as<unsigned short>();
-            SPRITE_OUT_OF_BOUNDS_ADJUSTMENT = config["sprite"]["out_of_bounds_adjustment"].as<unsigned short>();
-            PLAYER_Y_POS_BOUNDS_RUN = config["sprite"]["player_y_pos_bounds_run"].as<unsigned short>();
-
-            // Load player paths and settings
-            SPRITE1_PATH = config["sprites"]["sprite1"]["path"].as<std::string>();
-            SPRITE1_SPEED = config["sprites"]["sprite1"]["speed"].as<float>();
-            SPRITE1_ACCELERATION = {config["sprites"]["sprite1"]["acceleration"]["x"].as<float>(),
-                                config["sprites"]["sprite1"]["acceleration"]["y"].as<float>()};   
-            SPRITE1_JUMP_ACCELERATION = {config["sprites"]["sprite1"]["jump_acceleration"]["x"].as<float>(),
-                                config["sprites"]["sprite1"]["jump_acceleration"]["y"].as<float>()};           
-            SPRITE1_INDEXMAX = config["sprites"]["sprite1"]["index_max"].as<short>();
-            SPRITE1_ANIMATIONROWS = config["sprites"]["sprite1"]["animation_rows"].as<short>();
-            SPRITE1_POSITION = {config["sprites"]["sprite1"]["position"]["x"].as<float>(),
-                                config["sprites"]["sprite1"]["position"]["y"].as<float>()};
-            SPRITE1_SCALE = {config["sprites"]["sprite1"]["scale"]["x"].as<float>(),
-                            config["sprites"]["sprite1"]["scale"]["y"].as<float>()};
-
-            // Load enemy paths and settings
-            BUTTON1_PATH = config["sprites"]["button1"]["path"].as<std::string>();
-            BUTTON1_INDEXMAX = config["sprites"]["button1"]["index_max"].as<short>();
-            BUTTON1_ANIMATIONROWS = config["sprites"]["button1"]["animation_rows"].as<short>();
-            BUTTON1_POSITION = {config["sprites"]["button1"]["position"]["x"].as<float>(),
-                                config["sprites"]["button1"]["position"]["y"].as<float>()};
-            BUTTON1_SCALE = {config["sprites"]["button1"]["scale"]["x"].as<float>(),
-                            config["sprites"]["button1"]["scale"]["y"].as<float>()};                
-            
-            // Load bullet paths and settings
-            BULLET_PATH = config["sprites"]["bullet"]["path"].as<std::string>();
-            BULLET_INITIALSPEED = config["sprites"]["bullet"]["speed"].as<float>();
-            BULLET_ACCELERATION = {config["sprites"]["bullet"]["acceleration"]["x"].as<float>(),
-                                config["sprites"]["bullet"]["acceleration"]["y"].as<float>()};           
-            BULLET_INDEXMAX = config["sprites"]["bullet"]["index_max"].as<short>();
-            BULLET_ANIMATIONROWS = config["sprites"]["bullet"]["animation_rows"].as<short>();
-            BULLET_STARTINGPOS = {config["sprites"]["bullet"]["position"]["x"].as<float>(),
-                                config["sprites"]["bullet"]["position"]["y"].as<float>()};
-            BULLET_STARTINGSCALE = {config["sprites"]["bullet"]["scale"]["x"].as<float>(),
-                            config["sprites"]["bullet"]["scale"]["y"].as<float>()};
-
-            // Load frame paths and settings
-            FRAME_PATH = config["sprites"]["frame"]["path"].as<std::string>();
-            FRAME_POSITION = {config["sprites"]["frame"]["position"]["x"].as<float>(),
-                                config["sprites"]["frame"]["position"]["y"].as<float>()};
-            FRAME_SCALE = {config["sprites"]["frame"]["scale"]["x"].as<float>(),
-                            config["sprites"]["frame"]["scale"]["y"].as<float>()};
-
-            // Load background (in the big screen) settings
-            BACKGROUNDBIG_PATH = config["sprites"]["background_big"]["path"].as<std::string>();
-            BACKGROUNDBIG_POSITION = {config["sprites"]["background_big"]["position"]["x"].as<float>(),
-                                    config["sprites"]["background_big"]["position"]["y"].as<float>()};
-            BACKGROUNDBIG_SCALE = {config["sprites"]["background_big"]["scale"]["x"].as<float>(),
-                                config["sprites"]["background_big"]["scale"]["y"].as<float>()};
-
-            BACKGROUNDBIGFINAL_PATH = config["sprites"]["background_big_final"]["path"].as<std::string>();
-            BACKGROUNDBIGFINAL_POSITION = {config["sprites"]["background_big_final"]["position"]["x"].as<float>(),
-                                    config["sprites"]["background_big_final"]["position"]["y"].as<float>()};
-            BACKGROUNDBIGFINAL_SCALE = {config["sprites"]["background_big_final"]["scale"]["x"].as<float>(),
-                                config["sprites"]["background_big_final"]["scale"]["y"].as<float>()};
-
-            BACKGROUNDBIGSTART_PATH = config["sprites"]["background_big_start"]["path"].as<std::string>();
-            BACKGROUNDBIGSTART_POSITION = {config["sprites"]["background_big_start"]["position"]["x"].as<float>(),
-                                    config["sprites"]["background_big_start"]["position"]["y"].as<float>()};
-            BACKGROUNDBIGSTART_SCALE = {config["sprites"]["background_big_start"]["scale"]["x"].as<float>(),
-                                config["sprites"]["background_big_start"]["scale"]["y"].as<float>()};
-
-            // Load tile settings
-            TILES_PATH = config["tiles"]["path"].as<std::string>();
-            TILES_ROWS = config["tiles"]["rows"].as<unsigned short>();
-            TILES_COLUMNS = config["tiles"]["columns"].as<unsigned short>();
-            TILES_NUM = config["tiles"]["number"].as<unsigned short>();
-            TILES_SCALE = {config["tiles"]["scale"]["x"].as<float>(),
-                        config["tiles"]["scale"]["y"].as<float>()};
-            TILE_WIDTH = config["tiles"]["tile_width"].as<unsigned short>();
-            TILE_HEIGHT = config["tiles"]["tile_height"].as<unsigned short>();
-            TILE_STARTINGINDEX = config["tiles"]["starting_index"].as<unsigned short>();
-            TILE_ENDINGINDEX = config["tiles"]["ending_index"].as<unsigned short>();
-            TILE_WALKABLEINDEX = config["tiles"]["walkable_index"].as<unsigned short>();
-            TILE_WALLINDEX = config["tiles"]["wall_index"].as<unsigned short>();
-            for (unsigned short i = 0; i < TILES_NUM; ++i) {
-                if (i == TILE_STARTINGINDEX || i == TILE_ENDINGINDEX || i == TILE_WALKABLEINDEX ){ 
-                    TILES_BOOLS[i] = true;
-                } else { 
-                    TILES_BOOLS[i] = false; 
-                }
+            Timer configTimer;
+
+            std::ifstream yamlStream(configFile, std::ios::binary);
+            if (!yamlStream.is_open()) throw YAML::BadFile(configFile.string());
+            std::string yamlText((std::istreambuf_iterator<char>(yamlStream)), std::istreambuf_iterator<char>());
+            CONFIG_HASH = fnv1a(yamlText.data(), yamlText.size());
+
+            std::filesystem::path snapshotPath = configFile;
+            snapshotPath += ".snapshot";
+
+            if (readConfigSnapshot(snapshotPath, CONFIG_HASH)) {
+                deriveConfigValues();
+                configTimer.End("Read config from snapshot");
+                return;
             }
-            
-            // Load tilemap settings
-            TILEMAP_POSITION = {config["tilemap"]["position"]["x"].as<float>(),
-                                config["tilemap"]["position"]["y"].as<float>()};
-            TILEMAP_WIDTH = config["tilemap"]["width"].as<size_t>();
-            TILEMAP_HEIGHT = config["tilemap"]["height"].as<size_t>();
-            TILEMAP_BOUNDARYOFFSET = config["tilemap"]["boundary_offset"].as<float>();
-            TILEMAP_FILEPATH = config["tilemap"]["filepath"].as<std::string>();
-            TILEMAP_PLAYERSPAWNINDEX = config["tilemap"]["playerspawn_index"].as<size_t>();
-            TILEMAP_GOALINDEX = config["tilemap"]["goal_index"].as<size_t>();
-
-            // Load text settings
-            TEXT_SIZE = config["text"]["size"].as<unsigned short>();
-            TEXT_PATH = config["text"]["font_path"].as<std::string>();
-            TEXT_MESSAGE = config["text"]["message"].as<std::string>();
-            TEXT_POSITION = {config["text"]["position"]["x"].as<float>(),
-                            config["text"]["position"]["y"].as<float>()};
-            TEXT_COLOR = SpriteComponents::toSfColor(config["text"]["color"].as<std::string>());
-
-            SCORETEXT_SIZE = config["score_text"]["size"].as<unsigned short>();
-            SCORETEXT_MESSAGE = config["score_text"]["message"].as<std::string>();
-            SCORETEXT_POSITION = {config["score_text"]["position"]["x"].as<float>(),
-                                config["score_text"]["position"]["y"].as<float>()};
-            SCORETEXT_COLOR = SpriteComponents::toSfColor(config["score_text"]["color"].as<std::string>());
-
-            ENDINGTEXT_SIZE = config["ending_text"]["size"].as<unsigned short>();
-            ENDINGTEXT_MESSAGE = config["ending_text"]["message"].as<std::string>();
-            ENDINGTEXT_POSITION = {config["ending_text"]["position"]["x"].as<float>(),
-                                config["ending_text"]["position"]["y"].as<float>()};
-            ENDINGTEXT_COLOR = SpriteComponents::toSfColor(config["ending_text"]["color"].as<std::string>());                    
-
-            // Load music settings
-            BACKGROUNDMUSIC_PATH = config["music"]["background_music"]["path"].as<std::string>();
-            BACKGROUNDMUSIC_VOLUME = config["music"]["background_music"]["volume"].as<float>();
-            BACKGROUNDMUSIC_LOOP = config["music"]["background_music"]["loop"].as<bool>();
-            BACKGROUNDMUSIC_ENDINGVOLUME = config["music"]["background_music"]["ending_volume"].as<float>();
-            
-            // Load sound settings
-            BUTTONCLICKSOUND_PATH = config["sound"]["button_click"]["path"].as<std::string>();
-            BUTTONCLICKSOUND_VOLUME = config["sound"]["button_click"]["volume"].as<float>();
-            
-            log_info("Succesfuly read yaml file");
+
+            std::vector<std::string> errors = loadConfigFields(YAML::Load(yamlText));
+            deriveConfigValues();
+
+            if (!errors.empty()) {
+                std::string report = "Config has " + std::to_string(errors.size()) + " invalid field(s), defaults used:";
+                for (const auto& error : errors) report += "\n\t" + error;
+                log_error(report);
+            } else {
+                writeConfigSnapshot(snapshotPath, CONFIG_HASH);
+            }
+            configTimer.End("Succesfuly read yaml file");
         } 
         catch (const YAML::BadFile& e) {
             log_error("Failed to load config file: " + std::string(e.what()));
@@ -282,6 +488,7 @@ namespace Constants {
     }
 
     void loadAssets(){  // load all sprites textures and stuff across scenes 
+        memory::Scope memoryScope(memory::Tag::Assets);
         // sprites
         if (!SPRITE1_TEXTURE->loadFromFile(SPRITE1_PATH)) log_warning("Failed to load sprite1 texture");
         if (!TILES_TEXTURE->loadFromFile(TILES_PATH)) log_warning("Failed to load tiles texture");
@@ -303,6 +510,7 @@ namespace Constants {
     }
 
     void makeRectsAndBitmasks(){
+        memory::Scope memoryScope(memory::Tag::Assets);
         SPRITE1_ANIMATIONRECTS.reserve(SPRITE1_INDEXMAX); 
         for (int row = 0; row < SPRITE1_ANIMATIONROWS; ++row) {
             for (int col = 0; col < SPRITE1_INDEXMAX / SPRITE1_ANIMATIONROWS; ++col) {
@@ -348,11 +556,13 @@ namespace Constants {
         for (const auto& rect : TILES_SINGLE_RECTS ) {
             TILES_BITMASKS.emplace_back(createBitmask(TILES_TEXTURE, rect));
         }
+        makeTilesMipChain();
 
         log_info("\tConstants initialized ");
     }
 
     void writeRandomTileMap(const std::filesystem::path filePath, std::function<void(std::ofstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex)> mazeGenerator) {
+        memory::Scope memoryScope(memory::Tag::Generators);
         try {
             std::ofstream fileStream(filePath);
 
@@ -368,20 +578,64 @@ namespace Constants {
     }
     
     void DFSmazeGenerator(std::ofstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex) {
-        // Create a grid filled with walls
-        std::vector<std::vector<unsigned short>> tileMap(TILEMAP_HEIGHT, std::vector<unsigned short>(TILEMAP_WIDTH, wallTileIndex));
+        MazeGrid grid(TILEMAP_WIDTH, TILEMAP_HEIGHT);
+        std::mt19937 rng(MAZE_SEED);
+        DFSmazeGrid(grid, { startingTileIndex, endingTileIndex, walkableTileIndex, wallTileIndex }, rng);
+
+        writeMazeGrid(file, grid);
+        file.close();
+        log_info("Successfully generated a DFS random maze with a guaranteed path.");
+    } 
+
+    void PrimsMazeGenerator(std::ofstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex) {
+        MazeGrid grid(TILEMAP_WIDTH, TILEMAP_HEIGHT);
+        std::mt19937 rng(MAZE_SEED);
+        PrimsMazeGrid(grid, { startingTileIndex, endingTileIndex, walkableTileIndex, wallTileIndex }, rng);
+
+        writeMazeGrid(file, grid);
+        file.close();
+        log_info("Successfully generated a Prim's Algorithm random maze with a guaranteed path.");
+    }
+
+    void SidewinderMazeGenerator(std::ofstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex) {
+        MazeBits bits(TILEMAP_WIDTH, TILEMAP_HEIGHT);
+        SidewinderMazeBits(bits, MAZE_SEED);
+        MazeGrid grid;
+        expandMazeBits(bits, { startingTileIndex, endingTileIndex, walkableTileIndex, wallTileIndex }, grid);
+
+        writeMazeGrid(file, grid);
+        file.close();
+        log_info("Successfully generated a Sidewinder random maze with a guaranteed path.");
+    }
+
+    void BinaryTreeMazeGenerator(std::ofstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex) {
+        MazeBits bits(TILEMAP_WIDTH, TILEMAP_HEIGHT);
+        BinaryTreeMazeBits(bits, MAZE_SEED);
+        MazeGrid grid;
+        expandMazeBits(bits, { startingTileIndex, endingTileIndex, walkableTileIndex, wallTileIndex }, grid);
+
+        writeMazeGrid(file, grid);
+        file.close();
+        log_info("Successfully generated a Binary Tree random maze with a guaranteed path.");
+    }
+
+    // in-memory generators; the file based ones above and the headless benchmarks share these
+    void DFSmazeGrid(MazeGrid& grid, const MazeTileKinds& kinds, std::mt19937& rng) {
+        memory::Scope memoryScope(memory::Tag::Generators);
+        // Fill the grid with walls
+        std::fill(grid.tiles.begin(), grid.tiles.end(), kinds.wall);
+        const int width = static_cast<int>(grid.width);
+        const int height = static_cast<int>(grid.height);
     
         // Maze generation setup
         std::stack<std::pair<int, int>> cellStack;
         std::vector<std::pair<int, int>> directions = {{0, -2}, {0, 2}, {-2, 0}, {2, 0}}; // Up, Down, Left, Right
-        std::random_device rd;
-        std::mt19937 rng(rd());
         std::shuffle(directions.begin(), directions.end(), rng);
     
         // Start position (inside the maze, must be odd)
         int startX = 1;
         int startY = 1;
-        tileMap[startY][startX] = walkableTileIndex;
+        grid.at(startX, startY) = kinds.walkable;
         cellStack.push({startX, startY});
     
         while (!cellStack.empty()) {
@@ -396,47 +650,38 @@ namespace Constants {
                 int my = y + dy / 2;
     
                 // Check if within bounds and unvisited
-                if (nx > 0 && ny > 0 && nx < TILEMAP_WIDTH - 1 && ny < TILEMAP_HEIGHT - 1 && tileMap[ny][nx] == wallTileIndex) {
-                    tileMap[my][mx] = walkableTileIndex; // Remove wall between
-                    tileMap[ny][nx] = walkableTileIndex; // Mark new cell as visited
+                if (nx > 0 && ny > 0 && nx < width - 1 && ny < height - 1 && grid.at(nx, ny) == kinds.wall) {
+                    grid.at(mx, my) = kinds.walkable; // Remove wall between
+                    grid.at(nx, ny) = kinds.walkable; // Mark new cell as visited
                     cellStack.push({nx, ny});
                 }
             }
         }
     
         // Ensure there is a guaranteed path to goal
-        tileMap[1][1] = startingTileIndex;
-        tileMap[TILEMAP_HEIGHT - 2][TILEMAP_WIDTH - 2] = endingTileIndex;
-    
-        // Write the map to file
-        for (int y = 0; y < TILEMAP_HEIGHT; ++y) {
-            for (int x = 0; x < TILEMAP_WIDTH; ++x) {
-                file << tileMap[y][x] << " ";
-            }
-            file << std::endl;
-        }
-        file.close();
-        log_info("Successfully generated a DFS random maze with a guaranteed path.");
-    } 
+        grid.at(1, 1) = kinds.starting;
+        grid.at(width - 2, height - 2) = kinds.ending;
+    }
 
-    void PrimsMazeGenerator(std::ofstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex) {
-        // Create a grid filled with walls
-        std::vector<std::vector<unsigned short>> tileMap(TILEMAP_HEIGHT, std::vector<unsigned short>(TILEMAP_WIDTH, wallTileIndex));
+    void PrimsMazeGrid(MazeGrid& grid, const MazeTileKinds& kinds, std::mt19937& rng) {
+        memory::Scope memoryScope(memory::Tag::Generators);
+        // Fill the grid with walls
+        std::fill(grid.tiles.begin(), grid.tiles.end(), kinds.wall);
+        const int width = static_cast<int>(grid.width);
+        const int height = static_cast<int>(grid.height);
     
         // Priority queue to store frontier walls
         std::vector<std::pair<int, int>> frontier;
-        std::random_device rd;
-        std::mt19937 rng(rd());
     
         // Start position (inside the maze, must be odd)
         int startX = 1;
         int startY = 1;
-        tileMap[startY][startX] = walkableTileIndex;
+        grid.at(startX, startY) = kinds.walkable;
         
         // Lambda function to add frontier walls
         auto addFrontier = [&](int x, int y) {
-            if (x > 0 && y > 0 && x < TILEMAP_WIDTH - 1 && y < TILEMAP_HEIGHT - 1 && tileMap[y][x] == wallTileIndex) {
-                tileMap[y][x] = 2; // Mark as frontier
+            if (x > 0 && y > 0 && x < width - 1 && y < height - 1 && grid.at(x, y) == kinds.wall) {
+                grid.at(x, y) = 2; // Mark as frontier
                 frontier.emplace_back(x, y);
             }
         };
@@ -454,16 +699,16 @@ namespace Constants {
     
             // Check neighbors (only odd-indexed tiles are valid paths)
             std::vector<std::pair<int, int>> neighbors;
-            if (y >= 2 && tileMap[y - 2][x] == walkableTileIndex) neighbors.emplace_back(x, y - 2);
-            if (y < TILEMAP_HEIGHT - 2 && tileMap[y + 2][x] == walkableTileIndex) neighbors.emplace_back(x, y + 2);
-            if (x >= 2 && tileMap[y][x - 2] == walkableTileIndex) neighbors.emplace_back(x - 2, y);
-            if (x < TILEMAP_WIDTH - 2 && tileMap[y][x + 2] == walkableTileIndex) neighbors.emplace_back(x + 2, y);
+            if (y >= 2 && grid.at(x, y - 2) == kinds.walkable) neighbors.emplace_back(x, y - 2);
+            if (y < height - 2 && grid.at(x, y + 2) == kinds.walkable) neighbors.emplace_back(x, y + 2);
+            if (x >= 2 && grid.at(x - 2, y) == kinds.walkable) neighbors.emplace_back(x - 2, y);
+            if (x < width - 2 && grid.at(x + 2, y) == kinds.walkable) neighbors.emplace_back(x + 2, y);
             
             if (!neighbors.empty()) {
                 std::shuffle(neighbors.begin(), neighbors.end(), rng);
                 auto [nx, ny] = neighbors.front();
-                tileMap[y][x] = walkableTileIndex;
-                tileMap[(y + ny) / 2][(x + nx) / 2] = walkableTileIndex; // Remove wall
+                grid.at(x, y) = kinds.walkable;
+                grid.at((x + nx) / 2, (y + ny) / 2) = kinds.walkable; // Remove wall
                 
                 // Add new frontier walls
                 addFrontier(x + 2, y);
@@ -474,22 +719,157 @@ namespace Constants {
         }
     
         // Ensure a guaranteed path to the goal
-        tileMap[1][1] = startingTileIndex;
-        tileMap[TILEMAP_HEIGHT - 2][TILEMAP_WIDTH - 2] = endingTileIndex;
-    
-        // Write the map to file
-        for (int y = 0; y < TILEMAP_HEIGHT; ++y) {
-            for (int x = 0; x < TILEMAP_WIDTH; ++x) {
-                file << tileMap[y][x] << " ";
+        grid.at(1, 1) = kinds.starting;
+        grid.at(width - 2, height - 2) = kinds.ending;
+    }
+
+    namespace {
+        constexpr size_t MAZE_BITS_ROW_GRAIN = 64; // rows per job chunk
+        constexpr std::uint64_t ODD_TILES = 0xAAAAAAAAAAAAAAAAull; // bits of a row word at odd x, where cells can be
+
+        // splitmix64: three multiply-xorshift steps per 64 random bits, and every seed is a good one
+        struct SplitMix64 {
+            std::uint64_t state;
+            std::uint64_t next() {
+                std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                return z ^ (z >> 31);
+            }
+        };
+
+        // each cell row gets its own stream, so rows can be generated in any order and on any thread with the same result
+        SplitMix64 cellRowRng(std::uint64_t seed, size_t cellRow) {
+            SplitMix64 mix { seed ^ (static_cast<std::uint64_t>(cellRow) * 0xD1B54A32D192ED03ull) };
+            return SplitMix64 { mix.next() };
+        }
+
+        // per word of a row: the tiles inside the map, the cell tiles (odd x up to the last cell column) and the last cell's bit
+        struct MazeBitsRows {
+            explicit MazeBitsRows(MazeBits& bits) : inside(bits.wordsPerRow), cells(bits.wordsPerRow), lastCell(bits.wordsPerRow) {
+                for (size_t k = 0; k < bits.wordsPerRow; ++k) {
+                    const size_t first = 64 * k;
+                    inside[k] = bits.width - first >= 64 ? ~0ull : (1ull << (bits.width - first)) - 1;
+                }
+                std::fill(bits.words.begin(), bits.words.end(), 0);
+                for (size_t y = 0; y < bits.height; ++y) std::copy(inside.begin(), inside.end(), bits.row(y)); // all walls to begin with
+                if (bits.width < 3 || bits.height < 3) return;
+
+                const size_t lastCellX = (bits.width - 3) | 1;
+                for (size_t k = 0; k <= lastCellX / 64; ++k) {
+                    const size_t last = std::min<size_t>(63, lastCellX - 64 * k);
+                    cells[k] = ODD_TILES & (last == 63 ? ~0ull : (2ull << last) - 1);
+                }
+                lastCell[lastCellX / 64] = 1ull << (lastCellX % 64);
+                cellRows = (((bits.height - 3) | 1) + 1) / 2;
+            }
+
+            std::vector<std::uint64_t> inside, cells, lastCell;
+            size_t cellRows = 0; // at y = 1, 3, 5...
+        };
+
+        /* writes cell row j: its own tile row, with the cells and the passages east of those in east, and the tile row above,
+        open where north has a cell. Row 0 (j == 0) stays wall */
+        void carveCellRow(MazeBits& bits, const MazeBitsRows& rows, size_t j, const std::uint64_t* east, const std::uint64_t* north) {
+            std::uint64_t* cellRow = bits.row(2 * j + 1);
+            std::uint64_t carry = 0; // the passage east of a cell in bit 63 is the next word's bit 0
+            for (size_t k = 0; k < bits.wordsPerRow; ++k) {
+                cellRow[k] = rows.inside[k] & ~(rows.cells[k] | (east[k] << 1) | carry);
+                carry = east[k] >> 63;
+            }
+            if (j == 0) return;
+            std::uint64_t* wallRow = bits.row(2 * j);
+            for (size_t k = 0; k < bits.wordsPerRow; ++k) wallRow[k] = rows.inside[k] & ~north[k];
+        }
+    }
+
+    /* Binary Tree: every cell opens north or east on one random bit, the top row east only and the last column north only,
+    so every cell links toward the top right corner. A word of random bits decides 32 cells */
+    void BinaryTreeMazeBits(MazeBits& bits, std::uint64_t seed) {
+        memory::Scope memoryScope(memory::Tag::Generators);
+        const MazeBitsRows rows(bits);
+        jobs::engineJobs().parallelForRange(0, rows.cellRows, [&](size_t rangeBegin, size_t rangeEnd) {
+            memory::Scope workerScope(memory::Tag::Generators);
+            std::vector<std::uint64_t> east(bits.wordsPerRow), north(bits.wordsPerRow);
+            for (size_t j = rangeBegin; j < rangeEnd; ++j) {
+                SplitMix64 rng = cellRowRng(seed, j);
+                for (size_t k = 0; k < bits.wordsPerRow; ++k) {
+                    const std::uint64_t random = j == 0 ? ~0ull : rng.next();
+                    east[k] = random & rows.cells[k] & ~rows.lastCell[k];
+                    north[k] = (~random & rows.cells[k]) | rows.lastCell[k];
+                }
+                carveCellRow(bits, rows, j, east.data(), north.data());
+            }
+        }, MAZE_BITS_ROW_GRAIN);
+    }
+
+    /* Sidewinder: a row is cut into runs of cells joined east, a run closing at a random cell (always at the last column),
+    and each run below the top opens north from one of its cells. The top row is a single run with no way north.
+    The cell a run opens north from is its first one with a second random bit set, or its closing cell; for all runs of a
+    row at once that is M & ~(M - starts), M being the candidates and closing cells: subtracting a run's start bit borrows
+    up to the first candidate at or after it, and never past it, since a run's closing cell is a candidate */
+    void SidewinderMazeBits(MazeBits& bits, std::uint64_t seed) {
+        memory::Scope memoryScope(memory::Tag::Generators);
+        const MazeBitsRows rows(bits);
+        jobs::engineJobs().parallelForRange(0, rows.cellRows, [&](size_t rangeBegin, size_t rangeEnd) {
+            memory::Scope workerScope(memory::Tag::Generators);
+            std::vector<std::uint64_t> east(bits.wordsPerRow), north(bits.wordsPerRow);
+            for (size_t j = rangeBegin; j < rangeEnd; ++j) {
+                SplitMix64 rng = cellRowRng(seed, j);
+                std::uint64_t closedCarry = 2; // the first cell (x = 1) starts a run
+                std::uint64_t borrow = 0;
+                for (size_t k = 0; k < bits.wordsPerRow; ++k) {
+                    const std::uint64_t closeBits = j == 0 ? 0 : rng.next();
+                    const std::uint64_t candidateBits = j == 0 ? 0 : rng.next();
+                    const std::uint64_t closed = (closeBits & rows.cells[k]) | rows.lastCell[k];
+                    const std::uint64_t starts = rows.cells[k] & ((closed << 2) | closedCarry); // two tiles on from a closing cell
+                    closedCarry = closed >> 62;
+                    east[k] = rows.cells[k] & ~closed;
+
+                    const std::uint64_t candidates = (candidateBits & rows.cells[k]) | closed;
+                    const std::uint64_t difference = candidates - starts;
+                    const std::uint64_t remainder = difference - borrow;
+                    borrow = (candidates < starts) | (difference < borrow);
+                    north[k] = candidates & ~remainder;
+                }
+                carveCellRow(bits, rows, j, east.data(), north.data());
+            }
+        }, MAZE_BITS_ROW_GRAIN);
+    }
+
+    void expandMazeBits(const MazeBits& bits, const MazeTileKinds& kinds, MazeGrid& grid) {
+        memory::Scope memoryScope(memory::Tag::Generators);
+        if (grid.width != bits.width || grid.height != bits.height) grid = MazeGrid(bits.width, bits.height);
+        jobs::engineJobs().parallelFor(0, bits.height, [&](size_t y) {
+            const std::uint64_t* row = bits.row(y);
+            unsigned short* tiles = &grid.tiles[y * grid.width];
+            for (size_t x = 0; x < bits.width; ++x) tiles[x] = (row[x / 64] >> (x % 64)) & 1 ? kinds.wall : kinds.walkable;
+        }, MAZE_BITS_ROW_GRAIN);
+
+        if (bits.width < 3 || bits.height < 3) return;
+        // Ensure a guaranteed path to the goal
+        grid.at(1, 1) = kinds.starting;
+        grid.at(bits.width - 2, bits.height - 2) = kinds.ending;
+    }
+
+    void writeMazeGrid(std::ostream& file, const MazeGrid& grid) {
+        for (size_t y = 0; y < grid.height; ++y) {
+            for (size_t x = 0; x < grid.width; ++x) {
+                file << grid.at(x, y) << " ";
             }
             file << std::endl;
         }
-        
-        file.close();
-        log_info("Successfully generated a Prim's Algorithm random maze with a guaranteed path.");
+    }
+
+    bool readMazeGrid(std::istream& file, MazeGrid& grid) {
+        for (auto& tile : grid.tiles) {
+            if (!(file >> tile)) return false;
+        }
+        return true;
     }
 
     void generateTilePathInstruction(const std::filesystem::path filePath, std::function<void(std::ifstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex, const unsigned short tileMapWidth, const unsigned short tileMapHeight)> pathInstructionGenerator) {
+        memory::Scope memoryScope(memory::Tag::Pathfinding);
         try {
             std::ifstream fileStream(filePath);
 
@@ -510,38 +890,49 @@ namespace Constants {
     }
  
     void AstarPathInstructionGenerator(std::ifstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex, const unsigned short tileMapWidth, const unsigned short tileMapHeight) {
-        std::vector<unsigned short> tileMap(tileMapWidth * tileMapHeight);
-        
-        for (size_t i = 0; i < tileMap.size(); ++i) file >> tileMap[i];
+        MazeGrid grid(tileMapWidth, tileMapHeight);
+        readMazeGrid(file, grid);
         file.close();
+
+        // searches the maze's junction graph rather than every tile; the route is as short as AstarPath's
+        std::vector<size_t> path = navigation::solveMaze(grid, { startingTileIndex, endingTileIndex, walkableTileIndex, wallTileIndex });
+        if (path.empty()) return; // solveMaze logged why
+        TILEPATH_INSTRUCTION = std::move(path);
+        log_info("Successfully generated tile path instructions.");
+        //for(auto i : TILEPATH_INSTRUCTION) std::cout << i << " "; // for debugging
+    }
+
+    std::vector<size_t> AstarPath(const MazeGrid& grid, const MazeTileKinds& kinds) {
+        memory::Scope memoryScope(memory::Tag::Pathfinding);
+        const auto& tileMap = grid.tiles;
+        const size_t tileMapWidth = grid.width;
+        const size_t tileMapHeight = grid.height;
         
-        size_t startIndex = std::find(tileMap.begin(), tileMap.end(), startingTileIndex) - tileMap.begin();
-        size_t goalIndex = std::find(tileMap.begin(), tileMap.end(), endingTileIndex) - tileMap.begin();
+        size_t startIndex = std::find(tileMap.begin(), tileMap.end(), kinds.starting) - tileMap.begin();
+        size_t goalIndex = std::find(tileMap.begin(), tileMap.end(), kinds.ending) - tileMap.begin();
         
         if (startIndex >= tileMap.size() || goalIndex >= tileMap.size()) {
             log_warning("Player spawn or goal index not found.");
-            return;
+            return {};
         }
         
-        if (startIndex == goalIndex) {
-            TILEPATH_INSTRUCTION = { static_cast<unsigned short>(startIndex) };
-            log_info("Successfully generated tile path instructions.");
-            return;
-        }
+        if (startIndex == goalIndex) return { startIndex };
         
-        int goalX = goalIndex % tileMapWidth;
-        int goalY = goalIndex / tileMapWidth;
+        int goalX = static_cast<int>(goalIndex % tileMapWidth);
+        int goalY = static_cast<int>(goalIndex / tileMapWidth);
         
         auto heuristic = [goalX, goalY, tileMapWidth](size_t index) {
-            int x = index % tileMapWidth;
-            int y = index / tileMapWidth;
+            int x = static_cast<int>(index % tileMapWidth);
+            int y = static_cast<int>(index / tileMapWidth);
             return std::abs(x - goalX) + std::abs(y - goalY);
         };
         
+        // flat per-tile arrays instead of hash maps; the search order (and so the path) is unchanged
+        constexpr int UNSEEN = -1;
         std::priority_queue<std::pair<int, size_t>, std::vector<std::pair<int, size_t>>, std::greater<std::pair<int, size_t>>> pq;
-        std::unordered_map<size_t, size_t> parent;
-        std::unordered_set<size_t> visited;
-        std::unordered_map<size_t, int> gCost; 
+        std::vector<size_t> parent(tileMap.size(), tileMap.size());
+        std::vector<bool> visited(tileMap.size(), false);
+        std::vector<int> gCost(tileMap.size(), UNSEEN); 
         gCost[startIndex] = 0; // Initialize cost for start node
 
         pq.push({ heuristic(startIndex), startIndex });
@@ -556,39 +947,37 @@ namespace Constants {
                 std::vector<size_t> path;
                 size_t node = goalIndex;
                 while (node != startIndex) {
-                    path.push_back(static_cast<unsigned short>(node));
-                    auto it = parent.find(node);
-                    if (it == parent.end()) {
+                    path.push_back(node);
+                    node = parent[node];
+                    if (node >= tileMap.size()) {
                         log_warning("Path reconstruction failed.");
-                        return;
+                        return {};
                     }
-                    node = it->second;
                 }
-                path.push_back(static_cast<unsigned short>(startIndex));
-                TILEPATH_INSTRUCTION = path;
-                log_info("Successfully generated tile path instructions.");
-                //for(auto i : TILEPATH_INSTRUCTION) std::cout << i << " "; // for debugging
-                return;
+                path.push_back(startIndex);
+                return path;
             }
             
-            if (visited.count(currentIndex)) continue;
+            if (visited[currentIndex]) continue;
 
-            visited.insert(currentIndex);
+            visited[currentIndex] = true;
             
-            int x = currentIndex % tileMapWidth;
-            int y = currentIndex / tileMapWidth;
+            size_t x = currentIndex % tileMapWidth;
+            size_t y = currentIndex / tileMapWidth;
             
-            std::vector<size_t> neighbors;
+            std::array<size_t, 4> neighbors;
+            size_t neighborCount = 0;
 
-            if (x > 0) neighbors.push_back(y * tileMapWidth + (x - 1)); // Left
-            if (x < tileMapWidth - 1) neighbors.push_back(y * tileMapWidth + (x + 1)); // Right
-            if (y > 0) neighbors.push_back((y - 1) * tileMapWidth + x); // Up
-            if (y < tileMapHeight - 1) neighbors.push_back((y + 1) * tileMapWidth + x); // Down
+            if (x > 0) neighbors[neighborCount++] = y * tileMapWidth + (x - 1); // Left
+            if (x < tileMapWidth - 1) neighbors[neighborCount++] = y * tileMapWidth + (x + 1); // Right
+            if (y > 0) neighbors[neighborCount++] = (y - 1) * tileMapWidth + x; // Up
+            if (y < tileMapHeight - 1) neighbors[neighborCount++] = (y + 1) * tileMapWidth + x; // Down
             
-            for (size_t neighbor : neighbors) {
-                if (tileMap[neighbor] == walkableTileIndex || tileMap[neighbor] == endingTileIndex) {
+            for (size_t n = 0; n < neighborCount; ++n) {
+                size_t neighbor = neighbors[n];
+                if (tileMap[neighbor] == kinds.walkable || tileMap[neighbor] == kinds.ending) {
                     int newCost = gCost[currentIndex] + 1; // Uniform cost
-                    if (!gCost.count(neighbor) || newCost < gCost[neighbor]) {
+                    if (gCost[neighbor] == UNSEEN || newCost < gCost[neighbor]) {
                         gCost[neighbor] = newCost;
                         pq.push({ newCost + heuristic(neighbor), neighbor });
                         parent[neighbor] = currentIndex;
@@ -597,6 +986,57 @@ namespace Constants {
             }
         }
         log_warning("No path found between start and goal using A*.");
+        return {};
+    }
+
+    /* makeTilesMipChain box filters the tileset down by halves until a tile is one texel and stacks the levels vertically in
+    TILES_MIP_TEXTURE. The tiles are power-of-two sized and aligned, so no 2x2 box straddles two tiles and a level never bleeds
+    a neighbouring tile in, which mipmapping the atlas itself (sf::Texture::generateMipmap) would */
+    void makeTilesMipChain() {
+        TILES_MIP_OFFSETS.clear();
+        const sf::Vector2u size = TILES_TEXTURE->getSize();
+        if (size.x == 0 || size.y == 0 || TILE_WIDTH == 0 || TILE_HEIGHT == 0) {
+            log_warning("\tfailed to build tile mip chain ( tiles texture is empty )");
+            return;
+        }
+
+        std::vector<sf::Image> levels(1, TILES_TEXTURE->copyToImage());
+        unsigned int tileWidth = TILE_WIDTH, tileHeight = TILE_HEIGHT;
+        while (tileWidth % 2 == 0 && tileHeight % 2 == 0) {
+            const sf::Image& source = levels.back();
+            const sf::Vector2u sourceSize = source.getSize();
+            sf::Image level;
+            level.create(sourceSize.x / 2, sourceSize.y / 2);
+            for (unsigned int y = 0; y < sourceSize.y / 2; ++y) {
+                for (unsigned int x = 0; x < sourceSize.x / 2; ++x) {
+                    unsigned int sum[4] = {};
+                    for (unsigned int corner = 0; corner < 4; ++corner) {
+                        sf::Color texel = source.getPixel(2 * x + corner % 2, 2 * y + corner / 2);
+                        sum[0] += texel.r; sum[1] += texel.g; sum[2] += texel.b; sum[3] += texel.a;
+                    }
+                    level.setPixel(x, y, sf::Color((sum[0] + 2) / 4, (sum[1] + 2) / 4, (sum[2] + 2) / 4, (sum[3] + 2) / 4));
+                }
+            }
+            levels.push_back(std::move(level));
+            tileWidth /= 2;
+            tileHeight /= 2;
+        }
+
+        unsigned int stackHeight = 0;
+        for (const auto& level : levels) {
+            TILES_MIP_OFFSETS.emplace_back(0, stackHeight);
+            stackHeight += level.getSize().y;
+        }
+        sf::Image stack;
+        stack.create(size.x, stackHeight, sf::Color::Transparent);
+        for (size_t i = 0; i < levels.size(); ++i) stack.copy(levels[i], TILES_MIP_OFFSETS[i].x, TILES_MIP_OFFSETS[i].y);
+
+        if (!TILES_MIP_TEXTURE->loadFromImage(stack)) {
+            log_warning("\tfailed to upload tile mip chain");
+            TILES_MIP_OFFSETS.clear();
+            return;
+        }
+        log_info("\tTile mip chain built with " + std::to_string(levels.size()) + " levels");
     }
 
     std::shared_ptr<sf::Uint8[]> createBitmask( const std::shared_ptr<sf::Texture>& texture, const sf::IntRect& rect, const float transparency) {
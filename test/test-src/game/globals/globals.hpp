@@ -16,8 +16,12 @@
 #include <random>
 #include <stack>
 #include <unordered_set>
+#include <variant>
+#include <string_view>
+#include <type_traits>
 
 #include "../test-logging/log.hpp"
+#include "../test-logging/memoryStats.hpp"
 
 namespace SpriteComponents {
     enum Direction { NONE, LEFT, RIGHT, UP, DOWN };
@@ -34,7 +38,9 @@ namespace MetaComponents{
     inline sf::Vector2f smallViewmouseClickedPosition_f {}; 
 
     inline float globalTime {};
-    inline float deltaTime {}; 
+    inline float deltaTime {}; // fixed simulation step while a tick runs
+    inline float frameTime {}; // wall-clock time of the last rendered frame
+    inline float interpolationAlpha {}; // how far rendering is between the previous and current tick (0..1)
     inline float spacePressedElapsedTime{};
 
     extern sf::Clock clock;
@@ -49,13 +55,53 @@ namespace MetaComponents{
 }
 
 namespace Constants { // not actually "constants" in terms of being fixed, but should never be altered after being read from the config.yaml file
-    extern void initialize();
+    extern void initialize(std::uint32_t mazeSeed = 0); // 0: tilemap.seed from the config, or a random seed if that is 0 too
 
     extern sf::Vector2f makeRandomPosition(); 
 
     void writeRandomTileMap(const std::filesystem::path filePath, std::function<void(std::ofstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex)> DFSmazeGenerator); 
     void DFSmazeGenerator(std::ofstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex);
     void PrimsMazeGenerator(std::ofstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex);
+    void SidewinderMazeGenerator(std::ofstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex);
+    void BinaryTreeMazeGenerator(std::ofstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex);
+    
+    // In-memory maze: tile indices row by row, the same numbers the tilemap file holds
+    struct MazeGrid {
+        MazeGrid() = default;
+        MazeGrid(size_t gridWidth, size_t gridHeight) : width(gridWidth), height(gridHeight), tiles(gridWidth * gridHeight) {}
+        unsigned short& at(size_t x, size_t y) { return tiles[y * width + x]; }
+        unsigned short at(size_t x, size_t y) const { return tiles[y * width + x]; }
+
+        size_t width {};
+        size_t height {};
+        std::vector<unsigned short> tiles;
+    };
+    struct MazeTileKinds { unsigned short starting, ending, walkable, wall; };
+
+    /* Compact maze: one bit per tile, set for walls, row by row, every row padded to whole 64-tile words (padding bits clear).
+    Cells sit on odd coordinates as in MazeGrid, so expandMazeBits gives the layout the other generators write */
+    struct MazeBits {
+        MazeBits() = default;
+        MazeBits(size_t bitsWidth, size_t bitsHeight) : width(bitsWidth), height(bitsHeight), wordsPerRow((bitsWidth + 63) / 64), words(wordsPerRow * bitsHeight) {}
+        std::uint64_t* row(size_t y) { return words.data() + y * wordsPerRow; }
+        const std::uint64_t* row(size_t y) const { return words.data() + y * wordsPerRow; }
+        bool wall(size_t x, size_t y) const { return (row(y)[x / 64] >> (x % 64)) & 1; }
+
+        size_t width {};
+        size_t height {};
+        size_t wordsPerRow {};
+        std::vector<std::uint64_t> words;
+    };
+
+    void DFSmazeGrid(MazeGrid& grid, const MazeTileKinds& kinds, std::mt19937& rng);
+    void PrimsMazeGrid(MazeGrid& grid, const MazeTileKinds& kinds, std::mt19937& rng);
+    // row-local generators: each row's cells are decided a word (32 cells) at a time from random bits, rows in parallel
+    void SidewinderMazeBits(MazeBits& bits, std::uint64_t seed);
+    void BinaryTreeMazeBits(MazeBits& bits, std::uint64_t seed);
+    void expandMazeBits(const MazeBits& bits, const MazeTileKinds& kinds, MazeGrid& grid); // grid takes bits' size; start and end tiles as the other generators place them
+    void writeMazeGrid(std::ostream& file, const MazeGrid& grid);
+    bool readMazeGrid(std::istream& file, MazeGrid& grid);
+    std::vector<size_t> AstarPath(const MazeGrid& grid, const MazeTileKinds& kinds); // goal first, start last (TILEPATH_INSTRUCTION order); empty if none
     
     void generateTilePathInstruction(const std::filesystem::path filePath, std::function<void(std::ifstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex, const unsigned short tileMapWidth, const unsigned short tileMapHeight)> pathInstructionGenerator);
     void AstarPathInstructionGenerator(std::ifstream& file, const unsigned short startingTileIndex, const unsigned short endingTileIndex, const unsigned short walkableTileIndex, const unsigned short wallTileIndex, const unsigned short tileMapWidth, const unsigned short tileMapHeight);
@@ -68,12 +114,40 @@ namespace Constants { // not actually "constants" in terms of being fixed, but s
     void loadAssets(); 
     void readFromYaml(const std::filesystem::path configFile); 
     void makeRectsAndBitmasks(); 
+    void makeTilesMipChain(); 
+
+    // config schema; every yaml field is declared once in configSchema() and the loader and snapshot are driven by it
+    using ConfigTarget = std::variant<float*, unsigned short*, short*, size_t*, bool*, std::string*, std::filesystem::path*, sf::Vector2f*, sf::Color*>;
+    using ConfigValue = std::variant<float, unsigned short, short, size_t, bool, std::string, std::filesystem::path, sf::Vector2f, sf::Color>;
+
+    struct ConfigField {
+        std::string_view key; // dotted yaml path, e.g. "world.view.size_x"
+        ConfigTarget target;
+        ConfigValue fallback; // used when the key is missing or invalid
+    };
+
+    template<typename T>
+    ConfigField configField(std::string_view key, T& target, const std::common_type_t<T>& fallback) {
+        return { key, ConfigTarget(&target), ConfigValue(std::in_place_type<T>, fallback) };
+    }
+
+    const std::vector<ConfigField>& configSchema();
+    std::vector<std::string> loadConfigFields(const YAML::Node& config); // returns every field error, not just the first
+    void deriveConfigValues();
+
+    inline std::uint64_t CONFIG_HASH; // hash of the config.yaml bytes; keys the binary snapshot next to it
 
     // Game display settings
     inline float WORLD_SCALE;
     inline unsigned short WORLD_WIDTH;
     inline unsigned short WORLD_HEIGHT;
     inline unsigned short FRAME_LIMIT;
+    inline unsigned short TICK_RATE; // simulation ticks per second
+    inline float FIXED_TIME_STEP; // 1 / TICK_RATE
+    inline bool PIPELINED_RENDERING; // simulate on the main thread and draw snapshots on a render thread
+    inline bool VSYNC;
+    inline bool ADAPTIVE_PACING; // frame pacer follows the measured display refresh when display() blocks on it
+    inline bool SHOW_FRAME_STATS;
     inline std::string GAME_TITLE;
     inline sf::Vector2f VIEW_INITIAL_CENTER;
     inline float VIEW_SIZE_X;
@@ -103,6 +177,7 @@ namespace Constants { // not actually "constants" in terms of being fixed, but s
     inline sf::Vector2f SPRITE1_SCALE;
     inline sf::Vector2f SPRITE1_JUMP_ACCELERATION;
     inline float SPRITE1_SPEED;
+    inline float SPRITE1_TURN_SPEED; // degrees per second
     inline sf::Vector2f SPRITE1_ACCELERATION;
     inline std::shared_ptr<sf::Texture> SPRITE1_TEXTURE = std::make_shared<sf::Texture>();
     inline std::vector<sf::IntRect> SPRITE1_ANIMATIONRECTS;
@@ -163,6 +238,8 @@ namespace Constants { // not actually "constants" in terms of being fixed, but s
     inline unsigned short TILE_WIDTH;
     inline unsigned short TILE_HEIGHT;
     inline std::shared_ptr<sf::Texture> TILES_TEXTURE = std::make_shared<sf::Texture>();
+    inline std::shared_ptr<sf::Texture> TILES_MIP_TEXTURE = std::make_shared<sf::Texture>(); // every mip level of TILES_TEXTURE, stacked
+    inline std::vector<sf::Vector2u> TILES_MIP_OFFSETS; // where level n (1/2^n size) starts in TILES_MIP_TEXTURE; empty if it was not built
     inline std::vector<sf::IntRect> TILES_SINGLE_RECTS;
     inline std::vector<std::shared_ptr<sf::Uint8[]>> TILES_BITMASKS;
     inline unsigned short TILE_STARTINGINDEX;
@@ -177,6 +254,8 @@ namespace Constants { // not actually "constants" in terms of being fixed, but s
     inline std::filesystem::path TILEMAP_FILEPATH;
     inline size_t TILEMAP_PLAYERSPAWNINDEX;
     inline size_t TILEMAP_GOALINDEX;
+    inline size_t TILEMAP_SEED; // 0: new maze every run
+    inline std::uint32_t MAZE_SEED; // seed the maze was actually generated with; recordings store it
     inline std::vector<size_t> TILEPATH_INSTRUCTION;
 
     // Text settings
@@ -197,6 +276,10 @@ namespace Constants { // not actually "constants" in terms of being fixed, but s
     inline sf::Vector2f ENDINGTEXT_POSITION;
     inline sf::Color ENDINGTEXT_COLOR;
 
+    inline unsigned short STATSTEXT_SIZE;
+    inline sf::Vector2f STATSTEXT_POSITION;
+    inline sf::Color STATSTEXT_COLOR;
+
     // Music settings
     inline std::filesystem::path BACKGROUNDMUSIC_PATH;
     inline float BACKGROUNDMUSIC_VOLUME;
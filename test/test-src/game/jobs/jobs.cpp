@@ -0,0 +1,290 @@
+//
+//  jobs.cpp
+//  sfml game template
+//
+//
+
+#include "jobs.hpp"
+
+namespace jobs {
+
+    namespace {
+        // which system and deque the current thread owns, if any
+        thread_local JobSystem* currentSystem = nullptr;
+        thread_local unsigned currentIndex = 0;
+        thread_local unsigned victimSeed = 0x9e3779b9u;
+
+        unsigned nextVictim(unsigned count) {
+            victimSeed ^= victimSeed << 13; victimSeed ^= victimSeed >> 17; victimSeed ^= victimSeed << 5; // xorshift32
+            return victimSeed % count;
+        }
+
+        constexpr int64_t INDEX_MASK = static_cast<int64_t>(WorkStealingDeque::CAPACITY) - 1;
+        constexpr int IDLE_SPINS = 64; // failed searches before a worker goes to sleep
+        constexpr size_t CHUNKS_PER_THREAD = 32; // default grain aims for this many chunks per thread
+
+        // gives a half's count back however runRange is left; after that the half must not touch its range state again
+        struct RangeDone {
+            std::atomic<size_t>& remaining;
+            ~RangeDone() { remaining.fetch_sub(1, std::memory_order_acq_rel); }
+        };
+    }
+
+// WorkStealingDeque (ordering follows Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models")
+    bool WorkStealingDeque::push(Job* job) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= static_cast<int64_t>(CAPACITY)) return false;
+
+        buffer[b & INDEX_MASK].store(job, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_release); // publishes the slot to thieves
+        return true;
+    }
+
+    Job* WorkStealingDeque::pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) { // empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = buffer[b & INDEX_MASK].load(std::memory_order_relaxed);
+        if (t == b) { // last item, race the thieves for it
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job* WorkStealingDeque::steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        Job* job = buffer[t & INDEX_MASK].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr; // lost to another thief or the owner
+        return job;
+    }
+
+    size_t WorkStealingDeque::size() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+// JobSystem
+    JobSystem::JobSystem(unsigned workerCount) {
+        deques.reserve(workerCount + 1);
+        for (unsigned i = 0; i <= workerCount; ++i) deques.push_back(std::make_unique<WorkStealingDeque>());
+
+        previousSystem = currentSystem;
+        previousIndex = currentIndex;
+        currentSystem = this;
+        currentIndex = 0;
+
+        workers.reserve(workerCount);
+        for (unsigned i = 1; i <= workerCount; ++i) workers.emplace_back(&JobSystem::workerLoop, this, i);
+
+        log_info("Job system started with " + std::to_string(workerCount) + " worker threads");
+    }
+
+    JobSystem::~JobSystem() {
+        while (runOneJob()) {} // drain what is still queued so no job is dropped
+
+        stopping.store(true);
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wakeWorkers.notify_all();
+        for (auto& worker : workers) if (worker.joinable()) worker.join();
+
+        if (currentSystem == this) {
+            currentSystem = previousSystem;
+            currentIndex = previousIndex;
+        }
+    }
+
+    JobHandle JobSystem::schedule(std::function<void()> work, std::initializer_list<JobHandle> dependencies) {
+        return schedule(std::move(work), std::vector<JobHandle>(dependencies));
+    }
+
+    JobHandle JobSystem::schedule(std::function<void()> work, const std::vector<JobHandle>& dependencies) {
+        auto job = std::make_shared<Job>();
+        job->work = std::move(work);
+        job->self = job;
+
+        for (const auto& dependency : dependencies) {
+            if (!dependency.job) continue;
+            std::lock_guard<std::mutex> lock(dependency.job->continuationMutex);
+            if (dependency.job->finished.load(std::memory_order_acquire)) continue;
+            job->blockers.fetch_add(1, std::memory_order_relaxed);
+            dependency.job->continuations.push_back(job);
+        }
+
+        if (job->blockers.fetch_sub(1, std::memory_order_acq_rel) == 1) enqueue(job); // drop the wiring hold
+        return JobHandle(job);
+    }
+
+    void JobSystem::wait(const JobHandle& handle) {
+        while (!handle.isDone()) {
+            if (!runOneJob()) std::this_thread::yield();
+        }
+    }
+
+    void JobSystem::runParallelRange(size_t begin, size_t end, size_t grain, const RangeFunction& body) {
+        if (grain == 0) grain = std::max<size_t>(1, (end - begin) / (threadCount() * CHUNKS_PER_THREAD));
+
+        RangeState state;
+        runRange(begin, end, grain, body, state);
+
+        while (state.remaining.load(std::memory_order_acquire) > 0) { // participate until every split-off half is done
+            if (!runOneJob()) std::this_thread::yield();
+        }
+        if (state.error) std::rethrow_exception(state.error);
+    }
+
+    void JobSystem::runRange(size_t begin, size_t end, size_t grain, const RangeFunction& body, RangeState& state) {
+        RangeDone done { state.remaining };
+        try {
+            while (begin < end && !state.failed.load(std::memory_order_relaxed)) {
+                if (end - begin > grain && localQueueSize() == 0) { // nothing left for thieves: give them half
+                    size_t middle = begin + (end - begin) / 2;
+                    state.remaining.fetch_add(1, std::memory_order_relaxed);
+                    try {
+                        schedule([this, middle, end, grain, &body, &state] { runRange(middle, end, grain, body, state); });
+                    } catch (...) {
+                        state.remaining.fetch_sub(1, std::memory_order_relaxed); // never queued, so it will not give its count back
+                        throw;
+                    }
+                    end = middle;
+                    continue;
+                }
+                size_t chunkEnd = std::min(end, begin + grain);
+                body(begin, chunkEnd);
+                begin = chunkEnd;
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state.errorMutex);
+            if (!state.error) state.error = std::current_exception();
+            state.failed.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void JobSystem::enqueue(const std::shared_ptr<Job>& job) {
+        if (currentSystem == this) {
+            if (!deques[currentIndex]->push(job.get())) { // deque full: run it here rather than block
+                execute(job.get());
+                return;
+            }
+        } else {
+            std::lock_guard<std::mutex> lock(injectedMutex);
+            injected.push_back(job.get());
+        }
+
+        queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepingWorkers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex); // a worker between its check and its wait cannot miss this
+        }
+        wakeWorkers.notify_one();
+    }
+
+    void JobSystem::execute(Job* job) {
+        try {
+            job->work();
+        } catch (const std::exception& e) {
+            log_error("Exception in job: " + std::string(e.what()));
+        }
+        finish(job);
+    }
+
+    void JobSystem::finish(Job* job) {
+        std::vector<std::shared_ptr<Job>> ready;
+        {
+            std::lock_guard<std::mutex> lock(job->continuationMutex);
+            job->finished.store(true, std::memory_order_release);
+            ready.swap(job->continuations);
+        }
+        for (auto& continuation : ready) {
+            if (continuation->blockers.fetch_sub(1, std::memory_order_acq_rel) == 1) enqueue(continuation);
+        }
+
+        auto keepAlive = std::move(job->self); // last use of job, it may be freed when this goes out of scope
+        job->work = nullptr;
+    }
+
+    bool JobSystem::runOneJob() {
+        Job* job = findJob();
+        if (!job) return false;
+
+        queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        execute(job);
+        return true;
+    }
+
+    Job* JobSystem::findJob() {
+        bool ownsDeque = currentSystem == this;
+        if (ownsDeque) {
+            if (Job* job = deques[currentIndex]->pop()) return job;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(injectedMutex, std::try_to_lock);
+            if (lock.owns_lock() && !injected.empty()) {
+                Job* job = injected.front();
+                injected.pop_front();
+                return job;
+            }
+        }
+
+        unsigned count = static_cast<unsigned>(deques.size());
+        unsigned start = nextVictim(count);
+        for (unsigned i = 0; i < count; ++i) {
+            unsigned victim = (start + i) % count;
+            if (ownsDeque && victim == currentIndex) continue;
+            if (Job* job = deques[victim]->steal()) return job;
+        }
+        return nullptr;
+    }
+
+    size_t JobSystem::localQueueSize() {
+        if (currentSystem == this) return deques[currentIndex]->size();
+        std::lock_guard<std::mutex> lock(injectedMutex);
+        return injected.size();
+    }
+
+    void JobSystem::workerLoop(unsigned index) {
+        currentSystem = this;
+        currentIndex = index;
+        victimSeed ^= index * 0x85ebca6bu;
+
+        int idleSpins = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            if (runOneJob()) {
+                idleSpins = 0;
+                continue;
+            }
+            if (++idleSpins < IDLE_SPINS) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+            wakeWorkers.wait_for(lock, std::chrono::milliseconds(10), [this] {
+                return queuedJobs.load(std::memory_order_seq_cst) > 0 || stopping.load();
+            });
+            sleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
+            idleSpins = 0;
+        }
+    }
+
+    JobSystem& engineJobs() {
+        static JobSystem system;
+        return system;
+    }
+}
@@ -0,0 +1,139 @@
+//
+//  jobs.hpp
+//  sfml game template
+//
+//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <initializer_list>
+#include <exception>
+#include <algorithm>
+
+#include "../test-logging/log.hpp"
+
+/* jobs namespace is the work-stealing scheduler shared by the engine: every worker owns a Chase-Lev deque it pushes and pops
+at the bottom of, idle workers steal from the top of the others. The thread that creates the JobSystem (the main thread) owns
+deque 0 and runs jobs while it waits, so it is never just blocked on the workers */
+namespace jobs {
+
+    struct Job {
+        std::function<void()> work;
+        std::atomic<int> blockers {1}; // unfinished dependencies, plus one held by schedule() until the job is fully wired
+        std::mutex continuationMutex;
+        std::vector<std::shared_ptr<Job>> continuations; // jobs waiting on this one
+        std::atomic<bool> finished {false};
+        std::shared_ptr<Job> self; // keeps the job alive while it is queued or waiting on dependencies
+    };
+
+    // handle to a scheduled job, usable as a dependency of later jobs or to wait on
+    class JobHandle {
+    public:
+        JobHandle() = default;
+        bool isDone() const { return !job || job->finished.load(std::memory_order_acquire); }
+        explicit operator bool() const { return static_cast<bool>(job); }
+
+    private:
+        friend class JobSystem;
+        explicit JobHandle(std::shared_ptr<Job> job) : job(std::move(job)) {}
+        std::shared_ptr<Job> job;
+    };
+
+    // Chase-Lev deque of fixed capacity: push/pop only by the owning thread, steal by any thread
+    class WorkStealingDeque {
+    public:
+        static constexpr size_t CAPACITY = 4096; // power of two
+
+        bool push(Job* job); // false when full, the caller then runs the job itself
+        Job* pop();
+        Job* steal();
+        size_t size() const;
+
+    private:
+        alignas(64) std::atomic<int64_t> top {0};
+        alignas(64) std::atomic<int64_t> bottom {0};
+        std::unique_ptr<std::atomic<Job*>[]> buffer { new std::atomic<Job*>[CAPACITY] };
+    };
+
+    class JobSystem {
+    public:
+        explicit JobSystem(unsigned workerCount = defaultWorkerCount());
+        ~JobSystem();
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // queues work to run once every dependency has finished (continuation when dependencies are given)
+        JobHandle schedule(std::function<void()> work, std::initializer_list<JobHandle> dependencies = {});
+        JobHandle schedule(std::function<void()> work, const std::vector<JobHandle>& dependencies);
+
+        // runs other jobs on the calling thread until the job has finished
+        void wait(const JobHandle& handle);
+
+        /* calls body(i) for every i in [begin, end) and returns once all are done. Ranges are split lazily: a worker keeps
+        running grain-sized chunks and only hands off half of what it has left while its own deque is empty, so the split
+        count follows how many thieves are actually idle. grain 0 picks one from the range size and thread count. If a body
+        throws, chunks not started yet are skipped and the first exception is rethrown here once every chunk has stopped */
+        template<typename Body> void parallelFor(size_t begin, size_t end, Body&& body, size_t grain = 0) {
+            if (begin >= end) return;
+            auto rangeBody = [&body](size_t rangeBegin, size_t rangeEnd) { for (size_t i = rangeBegin; i < rangeEnd; ++i) body(i); };
+            runParallelRange(begin, end, grain, rangeBody);
+        }
+
+        // same as parallelFor but the body receives whole [rangeBegin, rangeEnd) chunks
+        template<typename RangeBody> void parallelForRange(size_t begin, size_t end, RangeBody&& body, size_t grain = 0) {
+            if (begin >= end) return;
+            runParallelRange(begin, end, grain, std::forward<RangeBody>(body));
+        }
+
+        unsigned threadCount() const { return static_cast<unsigned>(deques.size()); } // workers plus the owning thread
+        static unsigned defaultWorkerCount() { return std::max(1u, std::thread::hardware_concurrency()) - 1; }
+
+    private:
+        using RangeFunction = std::function<void(size_t, size_t)>;
+
+        // shared by the halves of one parallel range; lives on the stack of runParallelRange, which waits for all of them
+        struct RangeState {
+            std::atomic<size_t> remaining {1}; // the caller's half plus every half split off and not finished
+            std::atomic<bool> failed {false};
+            std::mutex errorMutex;
+            std::exception_ptr error; // the first exception a body threw
+        };
+
+        void runParallelRange(size_t begin, size_t end, size_t grain, const RangeFunction& body);
+        void runRange(size_t begin, size_t end, size_t grain, const RangeFunction& body, RangeState& state);
+
+        void enqueue(const std::shared_ptr<Job>& job);
+        void execute(Job* job);
+        void finish(Job* job);
+        bool runOneJob(); // false when nothing could be found
+        Job* findJob();
+        size_t localQueueSize();
+
+        void workerLoop(unsigned index);
+
+        std::vector<std::unique_ptr<WorkStealingDeque>> deques; // 0 belongs to the owning thread
+        JobSystem* previousSystem = nullptr; // what the owning thread ran jobs for before this one, given back on destruction
+        unsigned previousIndex = 0;
+        std::vector<std::thread> workers;
+
+        std::mutex injectedMutex;
+        std::deque<Job*> injected; // jobs scheduled from threads that own no deque
+
+        std::atomic<int> queuedJobs {0};
+        std::atomic<int> sleepingWorkers {0};
+        std::atomic<bool> stopping {false};
+        std::mutex sleepMutex;
+        std::condition_variable wakeWorkers;
+    };
+
+    // engine-wide scheduler, created on first use by the thread that first calls it
+    JobSystem& engineJobs();
+}
@@ -0,0 +1,152 @@
+//
+//  anyAngle.cpp
+//  sfml game template
+//
+//
+
+#include "anyAngle.hpp"
+
+#include <queue>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace navigation {
+
+    namespace {
+        float tileDistance(size_t a, size_t b, size_t width) {
+            float dx = static_cast<float>(a % width) - static_cast<float>(b % width);
+            float dy = static_cast<float>(a / width) - static_cast<float>(b / width);
+            return std::sqrt(dx * dx + dy * dy);
+        }
+    }
+
+    // grid traversal from centre to centre; boundary crossings are compared with integers so corners are hit exactly
+    bool lineOfSight(const WalkGrid& grid, size_t from, size_t to) {
+        if (!grid.isWalkable(from) || !grid.isWalkable(to)) return false;
+        const long width = static_cast<long>(grid.width);
+        long x = static_cast<long>(from) % width, y = static_cast<long>(from) / width;
+        const long targetX = static_cast<long>(to) % width, targetY = static_cast<long>(to) / width;
+        const long dx = std::abs(targetX - x), dy = std::abs(targetY - y);
+        const long stepX = targetX > x ? 1 : -1, stepY = targetY > y ? 1 : -1;
+        auto open = [&grid, width](long tileX, long tileY) { return grid.walkable[static_cast<size_t>(tileY * width + tileX)] != 0; };
+
+        // the k-th vertical boundary is crossed at t = (2k + 1) / (2 dx), the k-th horizontal one at (2k + 1) / (2 dy)
+        long crossedX = 0, crossedY = 0;
+        while (x != targetX || y != targetY) {
+            long compare = (2 * crossedX + 1) * dy - (2 * crossedY + 1) * dx; // < 0: the vertical boundary comes first
+            if (crossedY == dy || (crossedX < dx && compare < 0)) {
+                x += stepX;
+                ++crossedX;
+            } else if (crossedX == dx || compare > 0) {
+                y += stepY;
+                ++crossedY;
+            } else { // exactly through a corner
+                if (!open(x + stepX, y) || !open(x, y + stepY)) return false;
+                x += stepX;
+                y += stepY;
+                ++crossedX;
+                ++crossedY;
+            }
+            if (!open(x, y)) return false;
+        }
+        return true;
+    }
+
+    std::vector<size_t> smoothPath(const WalkGrid& grid, const std::vector<size_t>& tilePath) {
+        if (tilePath.size() < 3) return tilePath;
+
+        // walk from the start (the back) and keep the last tile still in sight of the current anchor
+        std::vector<size_t> waypoints { tilePath.back() };
+        size_t anchor = tilePath.size() - 1;
+        while (anchor > 0) {
+            size_t farthest = anchor - 1;
+            while (farthest > 0 && lineOfSight(grid, tilePath[anchor], tilePath[farthest - 1])) --farthest;
+            waypoints.push_back(tilePath[farthest]);
+            anchor = farthest;
+        }
+        std::reverse(waypoints.begin(), waypoints.end());
+        return waypoints;
+    }
+
+    std::vector<size_t> thetaStar(const WalkGrid& grid, size_t start, size_t goal) {
+        memory::Scope memoryScope(memory::Tag::Pathfinding);
+        if (!grid.isWalkable(start) || !grid.isWalkable(goal)) return {};
+        if (start == goal) return { start };
+
+        const size_t width = grid.width;
+        const size_t none = grid.size();
+        std::vector<float> cost(grid.size(), std::numeric_limits<float>::infinity());
+        std::vector<size_t> parent(grid.size(), none);
+        std::vector<std::uint8_t> closed(grid.size(), 0);
+        using Entry = std::pair<float, size_t>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+        cost[start] = 0.0f;
+        parent[start] = start;
+        open.push({ tileDistance(start, goal, width), start });
+
+        while (!open.empty()) {
+            size_t current = open.top().second;
+            open.pop();
+            if (closed[current]) continue;
+            closed[current] = 1;
+
+            if (current == goal) {
+                std::vector<size_t> waypoints;
+                for (size_t tile = goal; tile != start; tile = parent[tile]) waypoints.push_back(tile);
+                waypoints.push_back(start);
+                return waypoints;
+            }
+
+            const long x = static_cast<long>(current % width), y = static_cast<long>(current / width);
+            for (long offsetY = -1; offsetY <= 1; ++offsetY) {
+                for (long offsetX = -1; offsetX <= 1; ++offsetX) {
+                    if (!offsetX && !offsetY) continue;
+                    long neighborX = x + offsetX, neighborY = y + offsetY;
+                    if (neighborX < 0 || neighborY < 0 || neighborX >= static_cast<long>(width) || neighborY >= static_cast<long>(grid.height)) continue;
+                    size_t neighbor = static_cast<size_t>(neighborY) * width + static_cast<size_t>(neighborX);
+                    if (!grid.walkable[neighbor] || closed[neighbor]) continue;
+                    if (offsetX && offsetY && (!grid.walkable[current + offsetX] || !grid.walkable[static_cast<size_t>(neighborY) * width + x])) continue; // no corner cutting
+
+                    // path 2: straight from the grandparent when it can see the neighbour
+                    size_t from = lineOfSight(grid, parent[current], neighbor) ? parent[current] : current;
+                    float newCost = cost[from] + tileDistance(from, neighbor, width);
+                    if (newCost < cost[neighbor]) {
+                        cost[neighbor] = newCost;
+                        parent[neighbor] = from;
+                        open.push({ newCost + tileDistance(neighbor, goal, width), neighbor });
+                    }
+                }
+            }
+        }
+        return {};
+    }
+
+    float waypointPathLength(const std::vector<size_t>& waypoints, size_t width) {
+        float length = 0.0f;
+        for (size_t i = 1; i < waypoints.size(); ++i) length += tileDistance(waypoints[i - 1], waypoints[i], width);
+        return length;
+    }
+
+    bool followWaypoints(physics::NavigationPose& pose, float speed, float deltaTime, const physics::NavigationGrid& geometry, std::vector<size_t>& waypoints) {
+        float remaining = speed * deltaTime;
+        while (!waypoints.empty()) {
+            sf::Vector2f offset = tileCenter(waypoints.back(), geometry) - pose.position;
+            float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+            if (distance > 0.0f) {
+                pose.headingAngle = std::atan2(offset.y, offset.x) * 180.0f / static_cast<float>(M_PI);
+                if (pose.headingAngle < 0.0f) pose.headingAngle += 360.0f;
+            }
+
+            if (distance > remaining) {
+                pose.position += offset * (remaining / distance);
+                return true;
+            }
+            pose.position += offset;
+            remaining -= distance;
+            waypoints.pop_back();
+        }
+        return false;
+    }
+}
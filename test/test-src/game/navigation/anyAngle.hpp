@@ -0,0 +1,31 @@
+//
+//  anyAngle.hpp
+//  sfml game template
+//
+//
+
+#pragma once
+
+#include <vector>
+
+#include "navGrid.hpp"
+
+/* any-angle paths: waypoints joined by straight lines of any heading instead of tile-by-tile cardinal steps. Waypoints are
+tile indices in the TILEPATH_INSTRUCTION order (goal first, the next waypoint at the back); agents move between tile centres */
+namespace navigation {
+
+    /* true when the straight line between the two tile centres only crosses walkable tiles. Where the line passes exactly
+    through a tile corner both tiles beside the corner have to be walkable, so agents never squeeze between diagonal walls */
+    bool lineOfSight(const WalkGrid& grid, size_t from, size_t to);
+
+    // string pulling: keeps only the tiles where a path has to turn, checked with lineOfSight
+    std::vector<size_t> smoothPath(const WalkGrid& grid, const std::vector<size_t>& tilePath);
+
+    // Theta*: A* over 8-connected tiles where a tile may take its parent's parent when it is in sight; empty if no path
+    std::vector<size_t> thetaStar(const WalkGrid& grid, size_t start, size_t goal);
+
+    float waypointPathLength(const std::vector<size_t>& waypoints, size_t width); // in tiles
+
+    // moves straight toward the next waypoint's centre, carrying leftover movement past reached ones; false once done
+    bool followWaypoints(physics::NavigationPose& pose, float speed, float deltaTime, const physics::NavigationGrid& geometry, std::vector<size_t>& waypoints);
+}
@@ -0,0 +1,244 @@
+//
+//  batchPaths.cpp
+//  sfml game template
+//
+//
+
+#include "batchPaths.hpp"
+#include "../../../test-logging/memoryStats.hpp"
+
+namespace navigation {
+
+    namespace {
+        struct SearchWorkspace {
+            std::vector<std::uint32_t> visited; // generation of the search that last reached the tile
+            std::vector<std::uint32_t> wanted; // generation of the search that has a start on the tile
+            std::vector<Direction> toward; // next step toward the goal, valid where visited matches
+            std::vector<std::uint32_t> queue;
+            std::uint32_t generation = 0;
+
+            void begin(size_t tileCount) {
+                if (visited.size() != tileCount) {
+                    visited.assign(tileCount, 0);
+                    wanted.assign(tileCount, 0);
+                    toward.resize(tileCount);
+                    generation = 0;
+                }
+                if (++generation == 0) { // wrapped, stale stamps could match again
+                    std::fill(visited.begin(), visited.end(), 0);
+                    std::fill(wanted.begin(), wanted.end(), 0);
+                    generation = 1;
+                }
+                queue.clear();
+            }
+        };
+
+        thread_local SearchWorkspace workspace;
+
+        Direction opposite(Direction direction) {
+            switch (direction) {
+                case Direction::Right: return Direction::Left;
+                case Direction::Down: return Direction::Up;
+                case Direction::Left: return Direction::Right;
+                case Direction::Up: return Direction::Down;
+                default: return Direction::None;
+            }
+        }
+
+        // one reverse search for every query in the group; paths go to out, lengths[query] says how much each took
+        void solveGroup(const WalkGrid& grid, const std::vector<PathQuery>& queries, const std::uint32_t* first, const std::uint32_t* last,
+                        std::vector<std::uint32_t>& out, size_t* lengths) {
+            out.clear();
+            const size_t goal = queries[*first].goal;
+            if (!grid.isWalkable(goal)) {
+                for (const std::uint32_t* query = first; query != last; ++query) lengths[*query] = 0;
+                return;
+            }
+
+            SearchWorkspace& search = workspace;
+            search.begin(grid.size());
+            const std::uint32_t generation = search.generation;
+
+            size_t startsLeft = 0;
+            for (const std::uint32_t* query = first; query != last; ++query) {
+                size_t start = queries[*query].start;
+                if (grid.isWalkable(start) && search.wanted[start] != generation) {
+                    search.wanted[start] = generation;
+                    ++startsLeft;
+                }
+            }
+
+            search.visited[goal] = generation;
+            search.toward[goal] = Direction::None;
+            search.queue.push_back(static_cast<std::uint32_t>(goal));
+            if (search.wanted[goal] == generation) --startsLeft;
+
+            for (size_t head = 0; head < search.queue.size() && startsLeft; ++head) {
+                size_t current = search.queue[head];
+                grid.forEachNeighbor(current, [&](size_t neighbor, Direction step) {
+                    if (search.visited[neighbor] == generation) return;
+                    search.visited[neighbor] = generation;
+                    search.toward[neighbor] = opposite(step);
+                    search.queue.push_back(static_cast<std::uint32_t>(neighbor));
+                    if (search.wanted[neighbor] == generation) --startsLeft;
+                });
+            }
+
+            for (const std::uint32_t* query = first; query != last; ++query) {
+                size_t tile = queries[*query].start;
+                size_t before = out.size();
+                if (tile < grid.size() && search.visited[tile] == generation) {
+                    out.push_back(static_cast<std::uint32_t>(tile));
+                    while (tile != goal) {
+                        tile = stepIndex(tile, search.toward[tile], grid.width);
+                        out.push_back(static_cast<std::uint32_t>(tile));
+                    }
+                }
+                lengths[*query] = out.size() - before;
+            }
+        }
+    }
+
+    namespace {
+        // offsets hold each query's length at [query + 1]; turns them into offsets and copies the group buffers into tiles
+        void packGroups(PathBatch& result, jobs::JobSystem& system) {
+            const size_t queryCount = result.size();
+            for (size_t i = 0; i < queryCount; ++i) result.offsets[i + 1] += result.offsets[i];
+            result.tiles.resize(result.offsets[queryCount]);
+
+            // a group's paths sit in its buffer in the order of its queries
+            system.parallelFor(0, result.groups.size(), [&](size_t group) {
+                memory::Scope workerScope(memory::Tag::Pathfinding);
+                const auto [first, last] = result.groups[group];
+                const std::uint32_t* source = result.groupTiles[group].data();
+                for (size_t i = first; i < last; ++i) {
+                    size_t query = result.order[i];
+                    size_t length = result.pathLength(query);
+                    std::copy(source, source + length, result.tiles.begin() + result.offsets[query]);
+                    source += length;
+                }
+            }, 1);
+        }
+    }
+
+    namespace {
+        // splits order[first, end) into even chunks, one group each, and answers them on the graph
+        void solveInChunks(const CorridorGraph& graph, const std::vector<PathQuery>& queries, PathBatch& result, size_t first, jobs::JobSystem& system) {
+            const size_t count = result.order.size() - first;
+            const size_t chunk = std::max<size_t>(1, count / (system.threadCount() * 4));
+            const size_t firstGroup = result.groups.size();
+            for (size_t begin = first; begin < result.order.size(); begin += chunk) result.groups.emplace_back(begin, std::min(begin + chunk, result.order.size()));
+            if (result.groupTiles.size() < result.groups.size()) result.groupTiles.resize(result.groups.size());
+
+            system.parallelFor(firstGroup, result.groups.size(), [&](size_t group) {
+                memory::Scope workerScope(memory::Tag::Pathfinding);
+                const auto [begin, end] = result.groups[group];
+                std::vector<std::uint32_t>& out = result.groupTiles[group];
+                out.clear();
+                for (size_t i = begin; i < end; ++i) {
+                    const PathQuery& query = queries[result.order[i]];
+                    result.offsets[result.order[i] + 1] = graph.findPath(query.start, query.goal, out);
+                }
+            }, 1);
+        }
+    }
+
+    namespace {
+        // sorts order[first, end) by goal, one group per goal, and answers each group with one search on the grid
+        void solveByGoal(const WalkGrid& grid, const std::vector<PathQuery>& queries, PathBatch& result, size_t first, jobs::JobSystem& system) {
+            const size_t queryCount = result.order.size();
+            std::sort(result.order.begin() + first, result.order.end(), [&queries](std::uint32_t a, std::uint32_t b) {
+                return queries[a].goal != queries[b].goal ? queries[a].goal < queries[b].goal : a < b;
+            });
+            const size_t firstGroup = result.groups.size();
+            for (size_t begin = first; begin < queryCount;) {
+                size_t end = begin + 1;
+                while (end < queryCount && queries[result.order[end]].goal == queries[result.order[begin]].goal) ++end;
+                result.groups.emplace_back(begin, end);
+                begin = end;
+            }
+            if (result.groupTiles.size() < result.groups.size()) result.groupTiles.resize(result.groups.size());
+
+            // each group writes its queries' lengths into offsets[query + 1]; groups own disjoint queries
+            size_t* lengths = result.offsets.data() + 1;
+            system.parallelFor(firstGroup, result.groups.size(), [&](size_t group) {
+                memory::Scope workerScope(memory::Tag::Pathfinding);
+                const auto [begin, end] = result.groups[group];
+                solveGroup(grid, queries, result.order.data() + begin, result.order.data() + end, result.groupTiles[group], lengths);
+            }, 1);
+        }
+
+        // copies cache hits into the first group's buffer in query order and returns how many; the misses follow them in order
+        size_t takeCacheHits(const std::vector<PathQuery>& queries, PathBatch& result, PathCache& cache, std::uint64_t mapVersion) {
+            const size_t queryCount = queries.size();
+            result.order.clear();
+            result.groups.clear();
+            if (result.groupTiles.empty()) result.groupTiles.resize(1);
+            result.groupTiles[0].clear();
+            for (size_t query = 0; query < queryCount; ++query) {
+                size_t length = cache.find(queries[query].start, queries[query].goal, mapVersion, result.groupTiles[0]);
+                if (!length) continue;
+                result.offsets[query + 1] = length;
+                result.order.push_back(static_cast<std::uint32_t>(query));
+            }
+            const size_t hitCount = result.order.size();
+            result.groups.emplace_back(0, hitCount);
+            for (size_t query = 0; query < queryCount; ++query) {
+                if (!result.offsets[query + 1]) result.order.push_back(static_cast<std::uint32_t>(query));
+            }
+            return hitCount;
+        }
+    }
+
+    void findPaths(const WalkGrid& grid, const std::vector<PathQuery>& queries, PathBatch& result, jobs::JobSystem& system) {
+        const size_t queryCount = queries.size();
+        result.tiles.clear();
+        result.offsets.assign(queryCount + 1, 0);
+        if (!queryCount) return;
+
+        result.order.resize(queryCount);
+        for (size_t i = 0; i < queryCount; ++i) result.order[i] = static_cast<std::uint32_t>(i);
+        result.groups.clear();
+        solveByGoal(grid, queries, result, 0, system);
+        packGroups(result, system);
+    }
+
+    void findPaths(const WalkGrid& grid, const std::vector<PathQuery>& queries, PathBatch& result, PathCache& cache, std::uint64_t mapVersion, jobs::JobSystem& system) {
+        const size_t queryCount = queries.size();
+        result.tiles.clear();
+        result.offsets.assign(queryCount + 1, 0);
+        if (!queryCount) return;
+
+        // cache hits sit in the first group, the misses are grouped by goal after them
+        const size_t hitCount = takeCacheHits(queries, result, cache, mapVersion);
+        solveByGoal(grid, queries, result, hitCount, system);
+        packGroups(result, system);
+        for (size_t i = hitCount; i < queryCount; ++i) cache.insert(mapVersion, result.pathBegin(result.order[i]), result.pathEnd(result.order[i]));
+    }
+
+    void findPaths(const CorridorGraph& graph, const std::vector<PathQuery>& queries, PathBatch& result, jobs::JobSystem& system) {
+        const size_t queryCount = queries.size();
+        result.tiles.clear();
+        result.offsets.assign(queryCount + 1, 0);
+        if (!queryCount) return;
+
+        result.order.resize(queryCount);
+        for (size_t i = 0; i < queryCount; ++i) result.order[i] = static_cast<std::uint32_t>(i);
+        result.groups.clear();
+        solveInChunks(graph, queries, result, 0, system);
+        packGroups(result, system);
+    }
+
+    void findPaths(const CorridorGraph& graph, const std::vector<PathQuery>& queries, PathBatch& result, PathCache& cache, std::uint64_t mapVersion, jobs::JobSystem& system) {
+        const size_t queryCount = queries.size();
+        result.tiles.clear();
+        result.offsets.assign(queryCount + 1, 0);
+        if (!queryCount) return;
+
+        // cache hits sit in the first group, the misses follow in chunks
+        const size_t hitCount = takeCacheHits(queries, result, cache, mapVersion);
+        solveInChunks(graph, queries, result, hitCount, system);
+        packGroups(result, system);
+        for (size_t i = hitCount; i < queryCount; ++i) cache.insert(mapVersion, result.pathBegin(result.order[i]), result.pathEnd(result.order[i]));
+    }
+}
@@ -0,0 +1,55 @@
+//
+//  batchPaths.hpp
+//  sfml game template
+//
+//
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "navGrid.hpp"
+#include "corridorGraph.hpp"
+#include "pathCache.hpp"
+#include "../jobs/jobs.hpp"
+
+namespace navigation {
+
+    struct PathQuery {
+        size_t start = 0;
+        size_t goal = 0;
+    };
+
+    // every path back to back in one buffer; path i is tiles[offsets[i], offsets[i + 1]), start first, goal last, empty if none
+    struct PathBatch {
+        std::vector<std::uint32_t> tiles;
+        std::vector<size_t> offsets;
+
+        size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+        size_t pathLength(size_t query) const { return offsets[query + 1] - offsets[query]; }
+        const std::uint32_t* pathBegin(size_t query) const { return tiles.data() + offsets[query]; }
+        const std::uint32_t* pathEnd(size_t query) const { return tiles.data() + offsets[query + 1]; }
+
+        // scratch reused between batches
+        std::vector<std::uint32_t> order; // query indices sorted by goal
+        std::vector<std::pair<size_t, size_t>> groups; // [first, last) ranges of order answered together (sharing a goal on a WalkGrid)
+        std::vector<std::vector<std::uint32_t>> groupTiles; // each group's paths before they are packed
+    };
+
+    /* answers a batch of shortest-path queries on the job system. Queries are grouped by goal and each group is one
+    breadth-first search outward from its goal that stops once every start in the group is reached, so a hundred agents
+    chasing the same tile cost one search. Each thread keeps its search arrays between batches and never clears them (a
+    generation stamp marks what the current search touched). result keeps its capacity, so a batch every frame does not
+    allocate once warmed up */
+    void findPaths(const WalkGrid& grid, const std::vector<PathQuery>& queries, PathBatch& result, jobs::JobSystem& system = jobs::engineJobs());
+
+    // looks every query up in the cache first and groups only the misses by goal, which are then cached; mapVersion as for PathCache
+    void findPaths(const WalkGrid& grid, const std::vector<PathQuery>& queries, PathBatch& result, PathCache& cache, std::uint64_t mapVersion, jobs::JobSystem& system = jobs::engineJobs());
+
+    // the same batch answered one query at a time on a CorridorGraph; better once goals are scattered or the maze is large
+    void findPaths(const CorridorGraph& graph, const std::vector<PathQuery>& queries, PathBatch& result, jobs::JobSystem& system = jobs::engineJobs());
+
+    // looks every query up in the cache first and searches only the misses, which are then cached; mapVersion as for PathCache
+    void findPaths(const CorridorGraph& graph, const std::vector<PathQuery>& queries, PathBatch& result, PathCache& cache, std::uint64_t mapVersion, jobs::JobSystem& system = jobs::engineJobs());
+}
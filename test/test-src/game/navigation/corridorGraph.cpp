@@ -0,0 +1,435 @@
+//
+//  corridorGraph.cpp
+//  sfml game template
+//
+//
+
+#include "corridorGraph.hpp"
+
+#include <algorithm>
+
+namespace navigation {
+
+    namespace {
+        struct CoreSearch {
+            std::vector<std::uint32_t> seen; // generation of the search that last reached the node
+            std::vector<std::uint32_t> closed;
+            std::vector<std::uint32_t> target; // generation of the search that ends at the node
+            std::vector<std::uint64_t> cost;
+            std::vector<std::uint64_t> targetCost; // from the node down to the goal tile
+            std::vector<std::uint32_t> parentEdge; // NONE on the nodes the search started from
+            std::vector<std::uint32_t> parentNode;
+            std::vector<std::uint8_t> startAnchor; // which of the start's anchors a source node came from
+            std::vector<std::uint8_t> goalAnchor; // and which of the goal's a target leads to
+            std::vector<std::pair<std::uint64_t, std::uint32_t>> heap;
+            std::uint32_t generation = 0;
+
+            void begin(size_t nodeCount) {
+                if (seen.size() != nodeCount) {
+                    seen.assign(nodeCount, 0);
+                    closed.assign(nodeCount, 0);
+                    target.assign(nodeCount, 0);
+                    cost.resize(nodeCount);
+                    targetCost.resize(nodeCount);
+                    parentEdge.resize(nodeCount);
+                    parentNode.resize(nodeCount);
+                    startAnchor.resize(nodeCount);
+                    goalAnchor.resize(nodeCount);
+                    generation = 0;
+                }
+                if (++generation == 0) { // wrapped, stale stamps could match again
+                    std::fill(seen.begin(), seen.end(), 0);
+                    std::fill(closed.begin(), closed.end(), 0);
+                    std::fill(target.begin(), target.end(), 0);
+                    generation = 1;
+                }
+                heap.clear();
+            }
+        };
+
+        thread_local CoreSearch coreSearch;
+    }
+
+    CorridorGraph CorridorGraph::build(const WalkGrid& grid) {
+        memory::Scope memoryScope(memory::Tag::Pathfinding);
+        CorridorGraph graph;
+        const size_t tileCount = grid.size();
+        graph.width = grid.width;
+        graph.tileNode.assign(tileCount, NONE);
+        graph.tileEdge.assign(tileCount, NONE);
+        graph.tileOffset.assign(tileCount, 0);
+
+        // nodes on every walkable tile that is not the middle of a corridor
+        for (size_t tile = 0; tile < tileCount; ++tile) {
+            if (!grid.walkable[tile]) continue;
+            size_t degree = 0;
+            grid.forEachNeighbor(tile, [&degree](size_t, Direction) { ++degree; });
+            if (degree != 2) {
+                graph.tileNode[tile] = static_cast<std::uint32_t>(graph.nodeTile.size());
+                graph.nodeTile.push_back(static_cast<std::uint32_t>(tile));
+            }
+        }
+
+        // follows every corridor leaving the node; a corridor is traced once, from whichever end gets there first
+        auto trace = [&graph, &grid](std::uint32_t node) {
+            const size_t origin = graph.nodeTile[node];
+            grid.forEachNeighbor(origin, [&](size_t first, Direction) {
+                if (graph.tileNode[first] != NONE) { // neighbouring nodes, a corridor with no tiles
+                    if (origin < first) graph.edges.push_back({ node, graph.tileNode[first], static_cast<std::uint32_t>(graph.corridorTiles.size()), 0, true });
+                    return;
+                }
+                if (graph.tileEdge[first] != NONE) return;
+
+                const std::uint32_t edgeIndex = static_cast<std::uint32_t>(graph.edges.size());
+                Edge edge { node, NONE, static_cast<std::uint32_t>(graph.corridorTiles.size()), 0, true };
+                size_t previous = origin, current = first;
+                while (graph.tileNode[current] == NONE) {
+                    graph.tileEdge[current] = edgeIndex;
+                    graph.tileOffset[current] = edge.length++;
+                    graph.corridorTiles.push_back(static_cast<std::uint32_t>(current));
+                    size_t next = current;
+                    grid.forEachNeighbor(current, [previous, &next](size_t neighbor, Direction) { if (neighbor != previous) next = neighbor; });
+                    previous = current;
+                    current = next;
+                }
+                edge.to = graph.tileNode[current];
+                graph.edges.push_back(edge);
+            });
+        };
+        for (std::uint32_t node = 0; node < graph.nodeTile.size(); ++node) trace(node);
+
+        // a ring with no junction on it has no node yet; any of its tiles will do
+        for (size_t tile = 0; tile < tileCount; ++tile) {
+            if (!grid.walkable[tile] || graph.tileNode[tile] != NONE || graph.tileEdge[tile] != NONE) continue;
+            graph.tileNode[tile] = static_cast<std::uint32_t>(graph.nodeTile.size());
+            graph.nodeTile.push_back(static_cast<std::uint32_t>(tile));
+            trace(graph.tileNode[tile]);
+        }
+
+        const size_t nodeCount = graph.nodeTile.size();
+        graph.linkOffsets.assign(nodeCount + 1, 0);
+        for (const Edge& edge : graph.edges) {
+            ++graph.linkOffsets[edge.from + 1];
+            ++graph.linkOffsets[edge.to + 1];
+        }
+        for (size_t node = 0; node < nodeCount; ++node) graph.linkOffsets[node + 1] += graph.linkOffsets[node];
+        graph.links.resize(graph.linkOffsets[nodeCount]);
+        std::vector<std::uint32_t> cursor(graph.linkOffsets.begin(), graph.linkOffsets.end() - 1);
+        for (std::uint32_t edge = 0; edge < graph.edges.size(); ++edge) {
+            graph.links[cursor[graph.edges[edge].from]++] = { edge, graph.edges[edge].to };
+            graph.links[cursor[graph.edges[edge].to]++] = { edge, graph.edges[edge].from };
+        }
+
+        // dead-end filling on the node graph: peel nodes with at most one live edge until none are left
+        graph.exitEdge.assign(nodeCount, NONE);
+        graph.inCore.assign(nodeCount, 1);
+        std::vector<std::uint32_t> liveLinks(nodeCount);
+        std::vector<std::uint32_t> peelOrder;
+        for (std::uint32_t node = 0; node < nodeCount; ++node) {
+            liveLinks[node] = graph.linkOffsets[node + 1] - graph.linkOffsets[node];
+            if (liveLinks[node] <= 1) {
+                graph.inCore[node] = 0;
+                peelOrder.push_back(node);
+            }
+        }
+        for (size_t head = 0; head < peelOrder.size(); ++head) {
+            const std::uint32_t node = peelOrder[head];
+            for (std::uint32_t i = graph.linkOffsets[node]; i < graph.linkOffsets[node + 1]; ++i) {
+                Edge& edge = graph.edges[graph.links[i].edge];
+                if (!edge.core) continue;
+                edge.core = false;
+                graph.exitEdge[node] = graph.links[i].edge;
+                const std::uint32_t parent = graph.links[i].node;
+                if (--liveLinks[parent] <= 1 && graph.inCore[parent]) {
+                    graph.inCore[parent] = 0;
+                    peelOrder.push_back(parent);
+                }
+                break;
+            }
+        }
+
+        // a parent is peeled after its children, so walking the peel order backwards sees parents first
+        graph.terminal.resize(nodeCount);
+        graph.depth.assign(nodeCount, 0);
+        for (std::uint32_t node = 0; node < nodeCount; ++node) graph.terminal[node] = node;
+        for (auto node = peelOrder.rbegin(); node != peelOrder.rend(); ++node) {
+            if (graph.exitEdge[*node] == NONE) continue; // root of a tree with no core
+            const std::uint32_t parent = graph.edges[graph.exitEdge[*node]].other(*node);
+            graph.terminal[*node] = graph.terminal[parent];
+            graph.depth[*node] = graph.depth[parent] + 1;
+        }
+        graph.coreNodes = nodeCount - peelOrder.size();
+        return graph;
+    }
+
+    std::uint64_t CorridorGraph::climbCost(std::uint32_t node, std::uint32_t until) const {
+        std::uint64_t cost = 0;
+        while (node != until) {
+            const Edge& edge = edges[exitEdge[node]];
+            cost += edge.weight();
+            node = edge.other(node);
+        }
+        return cost;
+    }
+
+    std::uint64_t CorridorGraph::treeDistance(std::uint32_t a, std::uint32_t b, std::uint32_t* ancestor) const {
+        std::uint64_t cost = 0;
+        auto climb = [this, &cost](std::uint32_t& node) {
+            const Edge& edge = edges[exitEdge[node]];
+            cost += edge.weight();
+            node = edge.other(node);
+        };
+        while (depth[a] > depth[b]) climb(a);
+        while (depth[b] > depth[a]) climb(b);
+        while (a != b) {
+            climb(a);
+            climb(b);
+        }
+        *ancestor = a;
+        return cost;
+    }
+
+    void CorridorGraph::appendClimb(std::uint32_t node, std::uint32_t until, std::vector<Step>& steps) const {
+        while (node != until) {
+            steps.push_back({ exitEdge[node], node });
+            node = edges[exitEdge[node]].other(node);
+        }
+    }
+
+    void CorridorGraph::appendDescent(std::uint32_t node, std::uint32_t until, std::vector<Step>& steps) const {
+        const size_t first = steps.size();
+        appendClimb(node, until, steps);
+        std::reverse(steps.begin() + first, steps.end());
+        for (size_t i = first; i < steps.size(); ++i) steps[i].from = edges[steps[i].edge].other(steps[i].from);
+    }
+
+    void CorridorGraph::appendEdge(const Step& step, std::vector<std::uint32_t>& out) const {
+        const Edge& edge = edges[step.edge];
+        const std::uint32_t* tiles = corridorTiles.data() + edge.firstTile;
+        if (step.from == edge.from) {
+            out.insert(out.end(), tiles, tiles + edge.length);
+            out.push_back(nodeTile[edge.to]);
+        } else {
+            for (std::uint32_t i = edge.length; i-- > 0;) out.push_back(tiles[i]);
+            out.push_back(nodeTile[edge.from]);
+        }
+    }
+
+    std::uint32_t CorridorGraph::heuristic(std::uint32_t node, size_t goal) const {
+        const size_t tile = nodeTile[node];
+        const size_t x = tile % width, y = tile / width, goalX = goal % width, goalY = goal / width;
+        return static_cast<std::uint32_t>((x > goalX ? x - goalX : goalX - x) + (y > goalY ? y - goalY : goalY - y));
+    }
+
+    std::vector<size_t> CorridorGraph::findPath(size_t start, size_t goal) const {
+        std::vector<std::uint32_t> tiles;
+        findPath(start, goal, tiles);
+        return std::vector<size_t>(tiles.begin(), tiles.end());
+    }
+
+    size_t CorridorGraph::findPath(size_t start, size_t goal, std::vector<std::uint32_t>& out) const {
+        auto walkable = [this](size_t tile) { return tile < tileNode.size() && (tileNode[tile] != NONE || tileEdge[tile] != NONE); };
+        if (!walkable(start) || !walkable(goal)) return 0;
+        const size_t before = out.size();
+        if (start == goal) {
+            out.push_back(static_cast<std::uint32_t>(start));
+            return 1;
+        }
+
+        // a tile in a corridor can leave through either end
+        auto anchorsOf = [this](size_t tile, Anchor* anchors) -> size_t {
+            if (tileNode[tile] != NONE) {
+                anchors[0] = { tileNode[tile], 0, 2 };
+                return 1;
+            }
+            const Edge& edge = edges[tileEdge[tile]];
+            anchors[0] = { edge.from, tileOffset[tile] + 1u, 0 };
+            anchors[1] = { edge.to, edge.length - tileOffset[tile], 1 };
+            return 2;
+        };
+        Anchor starts[2], goals[2];
+        const size_t startCount = anchorsOf(start, starts);
+        const size_t goalCount = anchorsOf(goal, goals);
+
+        enum class Route { None, Corridor, Tree, Core };
+        Route route = Route::None;
+        std::uint64_t best = UINT64_MAX;
+        size_t bestStart = 0, bestGoal = 0;
+        std::uint32_t ancestor = NONE;
+
+        if (tileEdge[start] != NONE && tileEdge[start] == tileEdge[goal]) {
+            best = tileOffset[start] > tileOffset[goal] ? tileOffset[start] - tileOffset[goal] : tileOffset[goal] - tileOffset[start];
+            route = Route::Corridor;
+        }
+        for (size_t s = 0; s < startCount; ++s) {
+            for (size_t g = 0; g < goalCount; ++g) {
+                if (terminal[starts[s].node] != terminal[goals[g].node]) continue;
+                std::uint32_t meet = NONE;
+                std::uint64_t cost = starts[s].cost + goals[g].cost + treeDistance(starts[s].node, goals[g].node, &meet);
+                if (cost < best) {
+                    best = cost;
+                    route = Route::Tree;
+                    bestStart = s;
+                    bestGoal = g;
+                    ancestor = meet;
+                }
+            }
+        }
+
+        // between different trees: A* over the core from the starts' terminals to the goals'
+        CoreSearch& search = coreSearch;
+        std::uint32_t meet = NONE;
+        bool coreStart = false, coreGoal = false;
+        for (size_t s = 0; s < startCount; ++s) coreStart = coreStart || inCore[terminal[starts[s].node]];
+        for (size_t g = 0; g < goalCount; ++g) coreGoal = coreGoal || inCore[terminal[goals[g].node]];
+        if (coreStart && coreGoal) {
+            search.begin(nodeCount());
+            const std::uint32_t generation = search.generation;
+            for (size_t g = 0; g < goalCount; ++g) {
+                const std::uint32_t node = terminal[goals[g].node];
+                if (!inCore[node]) continue;
+                std::uint64_t cost = goals[g].cost + climbCost(goals[g].node, node);
+                if (search.target[node] != generation || cost < search.targetCost[node]) {
+                    search.target[node] = generation;
+                    search.targetCost[node] = cost;
+                    search.goalAnchor[node] = static_cast<std::uint8_t>(g);
+                }
+            }
+            for (size_t s = 0; s < startCount; ++s) {
+                const std::uint32_t node = terminal[starts[s].node];
+                if (!inCore[node]) continue;
+                std::uint64_t cost = starts[s].cost + climbCost(starts[s].node, node);
+                if (search.seen[node] != generation || cost < search.cost[node]) {
+                    search.seen[node] = generation;
+                    search.cost[node] = cost;
+                    search.parentEdge[node] = NONE;
+                    search.startAnchor[node] = static_cast<std::uint8_t>(s);
+                    search.heap.push_back({ cost + heuristic(node, goal), node });
+                }
+            }
+            std::make_heap(search.heap.begin(), search.heap.end(), std::greater<>());
+
+            std::uint64_t coreBest = best;
+            while (!search.heap.empty() && search.heap.front().first < coreBest) {
+                std::pop_heap(search.heap.begin(), search.heap.end(), std::greater<>());
+                const std::uint32_t node = search.heap.back().second;
+                search.heap.pop_back();
+                if (search.closed[node] == generation) continue;
+                search.closed[node] = generation;
+
+                if (search.target[node] == generation && search.cost[node] + search.targetCost[node] < coreBest) {
+                    coreBest = search.cost[node] + search.targetCost[node];
+                    meet = node;
+                }
+                for (std::uint32_t i = linkOffsets[node]; i < linkOffsets[node + 1]; ++i) {
+                    const Edge& edge = edges[links[i].edge];
+                    if (!edge.core) continue;
+                    const std::uint32_t neighbor = links[i].node;
+                    const std::uint64_t cost = search.cost[node] + edge.weight();
+                    if (search.seen[neighbor] != generation || cost < search.cost[neighbor]) {
+                        search.seen[neighbor] = generation;
+                        search.cost[neighbor] = cost;
+                        search.parentEdge[neighbor] = links[i].edge;
+                        search.parentNode[neighbor] = node;
+                        search.heap.push_back({ cost + heuristic(neighbor, goal), neighbor });
+                        std::push_heap(search.heap.begin(), search.heap.end(), std::greater<>());
+                    }
+                }
+            }
+            if (meet != NONE) {
+                best = coreBest;
+                route = Route::Core;
+                bestGoal = search.goalAnchor[meet];
+                std::uint32_t source = meet;
+                while (search.parentEdge[source] != NONE) source = search.parentNode[source];
+                bestStart = search.startAnchor[source];
+            }
+        }
+        if (route == Route::None) return 0;
+
+        out.push_back(static_cast<std::uint32_t>(start));
+        if (route == Route::Corridor) {
+            const std::uint32_t* tiles = corridorTiles.data() + edges[tileEdge[start]].firstTile;
+            if (tileOffset[goal] > tileOffset[start]) out.insert(out.end(), tiles + tileOffset[start] + 1, tiles + tileOffset[goal] + 1);
+            else for (std::uint32_t i = tileOffset[start]; i-- > tileOffset[goal];) out.push_back(tiles[i]);
+            return out.size() - before;
+        }
+
+        const Anchor& from = starts[bestStart];
+        const Anchor& to = goals[bestGoal];
+        std::vector<Step> steps;
+        if (route == Route::Tree) {
+            appendClimb(from.node, ancestor, steps);
+            appendDescent(to.node, ancestor, steps);
+        } else {
+            appendClimb(from.node, terminal[from.node], steps);
+            const size_t first = steps.size();
+            for (std::uint32_t node = meet; search.parentEdge[node] != NONE; node = search.parentNode[node]) steps.push_back({ search.parentEdge[node], search.parentNode[node] });
+            std::reverse(steps.begin() + first, steps.end());
+            appendDescent(to.node, meet, steps);
+        }
+
+        // start tile out to its anchor, node to node, then in from the goal's anchor
+        if (from.side != 2) {
+            const Edge& edge = edges[tileEdge[start]];
+            const std::uint32_t* tiles = corridorTiles.data() + edge.firstTile;
+            if (from.side == 0) {
+                for (std::uint32_t i = tileOffset[start]; i-- > 0;) out.push_back(tiles[i]);
+                out.push_back(nodeTile[edge.from]);
+            } else {
+                out.insert(out.end(), tiles + tileOffset[start] + 1, tiles + edge.length);
+                out.push_back(nodeTile[edge.to]);
+            }
+        }
+        for (const Step& step : steps) appendEdge(step, out);
+        if (to.side != 2) {
+            const Edge& edge = edges[tileEdge[goal]];
+            const std::uint32_t* tiles = corridorTiles.data() + edge.firstTile;
+            if (to.side == 0) out.insert(out.end(), tiles, tiles + tileOffset[goal] + 1);
+            else for (std::uint32_t i = edge.length; i-- > tileOffset[goal];) out.push_back(tiles[i]);
+        }
+        return out.size() - before;
+    }
+
+    std::vector<size_t> solveMaze(const Constants::MazeGrid& maze, const Constants::MazeTileKinds& kinds, PathCache& cache, std::uint64_t mapVersion) {
+        memory::Scope memoryScope(memory::Tag::Pathfinding);
+        size_t startIndex = std::find(maze.tiles.begin(), maze.tiles.end(), kinds.starting) - maze.tiles.begin();
+        size_t goalIndex = std::find(maze.tiles.begin(), maze.tiles.end(), kinds.ending) - maze.tiles.begin();
+        if (startIndex >= maze.tiles.size() || goalIndex >= maze.tiles.size()) {
+            log_warning("Player spawn or goal index not found.");
+            return {};
+        }
+
+        thread_local std::vector<std::uint32_t> tiles; // start first, as the cache keeps paths
+        tiles.clear();
+        if (cache.find(startIndex, goalIndex, mapVersion, tiles) == 0) {
+            CorridorGraph::build(WalkGrid::fromMaze(maze, kinds)).findPath(startIndex, goalIndex, tiles);
+            if (tiles.empty()) {
+                log_warning("No path found between start and goal in the corridor graph.");
+                return {};
+            }
+            cache.insert(mapVersion, tiles.data(), tiles.data() + tiles.size());
+        }
+        return std::vector<size_t>(tiles.rbegin(), tiles.rend());
+    }
+
+    std::vector<size_t> solveMaze(const Constants::MazeGrid& maze, const Constants::MazeTileKinds& kinds) {
+        return solveMaze(maze, kinds, mazePathCache(), mazeVersion(maze, kinds));
+    }
+
+    // FNV-1a; a maze is hashed once per solve, far less work than building its graph
+    std::uint64_t mazeVersion(const Constants::MazeGrid& maze, const Constants::MazeTileKinds& kinds) {
+        std::uint64_t hash = 0xCBF29CE484222325ull;
+        auto mix = [&hash](std::uint64_t value) { hash = (hash ^ value) * 0x100000001B3ull; };
+        mix(maze.width);
+        mix(maze.height);
+        mix((static_cast<std::uint64_t>(kinds.starting) << 48) | (static_cast<std::uint64_t>(kinds.ending) << 32) | (static_cast<std::uint64_t>(kinds.walkable) << 16) | kinds.wall);
+        for (unsigned short tile : maze.tiles) mix(tile);
+        return hash;
+    }
+
+    PathCache& mazePathCache() {
+        thread_local PathCache cache(MAZE_PATH_CACHE_CAPACITY);
+        return cache;
+    }
+}
@@ -0,0 +1,86 @@
+//
+//  corridorGraph.hpp
+//  sfml game template
+//
+//
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "navGrid.hpp"
+#include "pathCache.hpp"
+
+namespace navigation {
+
+    /* a WalkGrid reduced to the tiles where a walker has a choice. Junctions and dead ends become nodes, and every corridor
+    between two of them becomes one weighted edge. Dead-end filling is then run on the node graph. Branches that can only lead
+    back out are peeled into trees hanging off the remaining core (in a perfect maze that is everything). A search only runs
+    over the core. Inside a tree the route is found by walking parent links up to the common ancestor. Tiles are only touched
+    again when the answer is written out. Built once per maze; queries are const and safe from any thread */
+    class CorridorGraph {
+    public:
+        static constexpr std::uint32_t NONE = UINT32_MAX;
+
+        static CorridorGraph build(const WalkGrid& grid);
+
+        // shortest path between two walkable tiles, start first and goal last; empty if either is blocked or they are not connected
+        std::vector<size_t> findPath(size_t start, size_t goal) const;
+        size_t findPath(size_t start, size_t goal, std::vector<std::uint32_t>& out) const; // appends the path, returns how many tiles
+
+        size_t tileCount() const { return tileNode.size(); }
+        size_t nodeCount() const { return nodeTile.size(); }
+        size_t edgeCount() const { return edges.size(); }
+        size_t coreNodeCount() const { return coreNodes; }
+
+    private:
+        struct Edge {
+            std::uint32_t from, to;
+            std::uint32_t firstTile; // corridor tiles are corridorTiles[firstTile, firstTile + length), walked from `from` to `to`
+            std::uint32_t length;
+            bool core;
+            std::uint32_t weight() const { return length + 1; }
+            std::uint32_t other(std::uint32_t node) const { return node == from ? to : from; }
+        };
+        struct Link { std::uint32_t edge, node; };
+        struct Anchor { std::uint32_t node; std::uint64_t cost; std::uint8_t side; }; // side: 0 toward edge.from, 1 toward edge.to, 2 on the node
+        struct Step { std::uint32_t edge, from; };
+
+        std::uint64_t climbCost(std::uint32_t node, std::uint32_t until) const;
+        std::uint64_t treeDistance(std::uint32_t a, std::uint32_t b, std::uint32_t* ancestor) const;
+        void appendClimb(std::uint32_t node, std::uint32_t until, std::vector<Step>& steps) const; // node up to until
+        void appendDescent(std::uint32_t node, std::uint32_t until, std::vector<Step>& steps) const; // until down to node
+        void appendEdge(const Step& step, std::vector<std::uint32_t>& out) const;
+        std::uint32_t heuristic(std::uint32_t node, size_t goal) const;
+
+        size_t width = 0;
+        std::vector<std::uint32_t> tileNode; // node standing on the tile, or NONE
+        std::vector<std::uint32_t> tileEdge; // corridor running through the tile, or NONE
+        std::vector<std::uint32_t> tileOffset; // position inside that corridor
+
+        std::vector<std::uint32_t> nodeTile;
+        std::vector<std::uint32_t> linkOffsets; // node i's links are links[linkOffsets[i], linkOffsets[i + 1])
+        std::vector<Link> links;
+        std::vector<Edge> edges;
+        std::vector<std::uint32_t> corridorTiles;
+
+        // dead-end trees; core nodes are their own terminal at depth 0
+        std::vector<std::uint8_t> inCore;
+        std::vector<std::uint32_t> exitEdge; // edge toward the core or the tree's root, NONE on core nodes and roots
+        std::vector<std::uint32_t> terminal; // core node the tree hangs off, or the root of a tree with no core
+        std::vector<std::uint32_t> depth; // edges up to the terminal
+        size_t coreNodes = 0;
+    };
+
+    constexpr size_t MAZE_PATH_CACHE_CAPACITY = 16; // per thread; maze routes can be long
+
+    /* the maze's route from start tile to goal tile through a CorridorGraph, in AstarPath's order (goal first, start last);
+    empty if none. The graph is only built on a cache miss: mapVersion keys the cache as for PathCache (TileMap::getVersion
+    of the map the maze was read from) */
+    std::vector<size_t> solveMaze(const Constants::MazeGrid& maze, const Constants::MazeTileKinds& kinds, PathCache& cache, std::uint64_t mapVersion);
+    // through this thread's mazePathCache, keyed by mazeVersion: for a maze no TileMap counts changes for yet
+    std::vector<size_t> solveMaze(const Constants::MazeGrid& maze, const Constants::MazeTileKinds& kinds);
+    std::uint64_t mazeVersion(const Constants::MazeGrid& maze, const Constants::MazeTileKinds& kinds); // hash of the size, tiles and kinds
+    PathCache& mazePathCache();
+}
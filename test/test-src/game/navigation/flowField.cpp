@@ -0,0 +1,97 @@
+//
+//  flowField.cpp
+//  sfml game template
+//
+//
+
+#include "flowField.hpp"
+
+namespace navigation {
+
+    namespace {
+        Direction opposite(Direction direction) {
+            switch (direction) {
+                case Direction::Right: return Direction::Left;
+                case Direction::Down: return Direction::Up;
+                case Direction::Left: return Direction::Right;
+                case Direction::Up: return Direction::Down;
+                default: return Direction::None;
+            }
+        }
+    }
+
+    void FlowField::build(const WalkGrid& walkGrid, size_t targetIndex) {
+        grid = &walkGrid;
+        width = walkGrid.width;
+        target = targetIndex;
+        rebuild();
+    }
+
+    // breadth-first from the target; each tile points back along the edge it was reached by
+    void FlowField::rebuild() {
+        memory::Scope memoryScope(memory::Tag::Pathfinding);
+        directions.assign(grid->size(), Direction::None);
+        movesSinceBuild = 0;
+        ++buildCount;
+        acyclic = true;
+        if (!grid->isWalkable(target)) return;
+
+        std::vector<std::uint8_t> seen(grid->size(), 0);
+        frontier.clear();
+        frontier.push_back(target);
+        seen[target] = 1;
+        size_t edgeEnds = 0;
+
+        for (size_t head = 0; head < frontier.size(); ++head) {
+            size_t current = frontier[head];
+            grid->forEachNeighbor(current, [&](size_t neighbor, Direction step) {
+                ++edgeEnds;
+                if (seen[neighbor]) return;
+                seen[neighbor] = 1;
+                directions[neighbor] = opposite(step);
+                frontier.push_back(neighbor);
+            });
+        }
+        acyclic = (edgeEnds / 2 == frontier.size() - 1); // a connected graph is a tree iff it has one edge fewer than tiles
+    }
+
+    bool FlowField::moveTarget(size_t newTargetIndex) {
+        if (!grid) return false;
+        if (newTargetIndex == target) return true;
+
+        Direction step = directionBetween(target, newTargetIndex, width);
+        bool reusable = step != Direction::None && grid->isWalkable(newTargetIndex) && reaches(newTargetIndex)
+                        && (acyclic || movesSinceBuild < FLOW_REBUILD_INTERVAL);
+
+        if (!reusable) {
+            target = newTargetIndex;
+            rebuild();
+            return false;
+        }
+
+        // re-root: the new target leaves the tree, the old target hangs off it
+        directions[newTargetIndex] = Direction::None;
+        directions[target] = step;
+        target = newTargetIndex;
+        ++movesSinceBuild;
+        return true;
+    }
+
+    void followFlowField(physics::NavigationPose& pose, float speed, float deltaTime, const physics::NavigationGrid& geometry, const FlowField& field) {
+        size_t tile = tileIndexAt(pose.position, geometry, field.tileCount());
+        if (tile == field.tileCount()) return; // off the grid, nothing to follow
+        size_t next = field.nextTile(tile);
+
+        // the straight line from anywhere in a tile to the centre of its neighbour stays inside the two tiles
+        sf::Vector2f goal = tileCenter(next, geometry);
+        sf::Vector2f offset = goal - pose.position;
+        float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+        float stepLength = speed * deltaTime;
+        if (distance <= stepLength || distance == 0.0f) {
+            pose.position = goal;
+        } else {
+            pose.position += offset * (stepLength / distance);
+        }
+        if (next != tile) pose.headingAngle = headingOf(field.direction(tile));
+    }
+}
@@ -0,0 +1,53 @@
+//
+//  flowField.hpp
+//  sfml game template
+//
+//
+
+#pragma once
+
+#include <vector>
+
+#include "navGrid.hpp"
+
+namespace navigation {
+
+    constexpr size_t FLOW_REBUILD_INTERVAL = 8; // incremental target moves on a map with loops before the field is rebuilt exactly
+
+    /* Shared next-step field toward one target tile: every tile stores the direction of its next step, so any number of agents
+    read their move in O(1) and the field costs the same for one pursuer as for a thousand.
+
+    The directions form a tree rooted at the target. When the target steps to a neighbouring tile the tree is re-rooted in
+    O(1): the new target stops, the old one points at it, every other tile keeps its direction. On a perfect maze (the only
+    kind the generators make) the tree is the maze itself, so the field stays exact. On a map with loops a re-rooted route can
+    be up to two tiles longer than the shortest for every move, so the field is rebuilt after FLOW_REBUILD_INTERVAL such moves. Jumps
+    of more than one tile always rebuild */
+    class FlowField {
+    public:
+        void build(const WalkGrid& walkGrid, size_t targetIndex); // the grid must outlive the field; build again after it changes
+        bool moveTarget(size_t newTargetIndex); // true when updated in place, false when it had to rebuild
+
+        Direction direction(size_t index) const { return index < directions.size() ? directions[index] : Direction::None; }
+        size_t nextTile(size_t index) const { return stepIndex(index, direction(index), width); } // index itself at the target or where unreachable
+        bool reaches(size_t index) const { return index == target || direction(index) != Direction::None; }
+        size_t getTarget() const { return target; }
+        size_t tileCount() const { return directions.size(); }
+        bool isExact() const { return acyclic || movesSinceBuild == 0; }
+        size_t getBuildCount() const { return buildCount; }
+
+    private:
+        void rebuild();
+
+        const WalkGrid* grid = nullptr;
+        std::vector<Direction> directions;
+        std::vector<size_t> frontier; // BFS queue, kept between rebuilds
+        size_t width = 0;
+        size_t target = 0;
+        size_t movesSinceBuild = 0;
+        size_t buildCount = 0;
+        bool acyclic = false; // the target's component is a tree, so re-rooting never loses exactness
+    };
+
+    // moves an agent one tick along the field: toward the centre of its next tile, or of its own tile at the target
+    void followFlowField(physics::NavigationPose& pose, float speed, float deltaTime, const physics::NavigationGrid& geometry, const FlowField& field);
+}
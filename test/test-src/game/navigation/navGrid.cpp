@@ -0,0 +1,82 @@
+//
+//  navGrid.cpp
+//  sfml game template
+//
+//
+
+#include "navGrid.hpp"
+
+namespace navigation {
+
+    WalkGrid WalkGrid::fromMaze(const Constants::MazeGrid& maze, const Constants::MazeTileKinds& kinds) {
+        WalkGrid grid;
+        grid.width = maze.width;
+        grid.height = maze.height;
+        grid.walkable.resize(maze.tiles.size());
+        for (size_t i = 0; i < maze.tiles.size(); ++i) {
+            unsigned short tile = maze.tiles[i];
+            grid.walkable[i] = (tile == kinds.walkable || tile == kinds.starting || tile == kinds.ending);
+        }
+        return grid;
+    }
+
+    WalkGrid WalkGrid::fromTileMap(TileMap& tileMap) {
+        WalkGrid grid;
+        grid.width = tileMap.getTileMapWidth();
+        grid.height = tileMap.getTileMapHeight();
+        grid.walkable.resize(grid.width * grid.height);
+        grid.mapVersion = tileMap.getVersion();
+        try {
+            for (size_t i = 0; i < grid.walkable.size(); ++i) {
+                const auto& tile = tileMap.getTile(i);
+                grid.walkable[i] = tile && tile->getWalkable();
+            }
+        } catch (const std::exception& e) {
+            log_error("Failed to read walkable tiles: " + std::string(e.what()));
+        }
+        return grid;
+    }
+
+    WalkGrid WalkGrid::fromSnapshot(const MapSnapshot& snapshot) {
+        WalkGrid grid;
+        grid.width = snapshot.getWidth();
+        grid.height = snapshot.getHeight();
+        grid.mapVersion = snapshot.getVersion();
+        grid.walkable.resize(grid.width * grid.height);
+        for (size_t y = 0; y < grid.height; ++y) {
+            for (size_t x = 0; x < grid.width; ++x) grid.walkable[y * grid.width + x] = snapshot.isWalkable(x, y);
+        }
+        return grid;
+    }
+
+    bool routeTouchedSince(const TileMap& tileMap, std::uint64_t since, const std::vector<std::uint8_t>& routeTiles, std::vector<TileChange>& changes) {
+        if (tileMap.getVersion() == since) return false;
+        changes.clear();
+        if (!tileMap.changesSince(since, changes)) return true;
+        for (const TileChange& change : changes) {
+            if (change.index < routeTiles.size() && routeTiles[change.index]) return true;
+        }
+        return false;
+    }
+
+    bool WalkGrid::syncWith(TileMap& tileMap) {
+        if (tileMap.getVersion() == mapVersion) return false;
+
+        thread_local std::vector<TileChange> changes;
+        changes.clear();
+        if (width != tileMap.getTileMapWidth() || height != tileMap.getTileMapHeight() || !tileMap.changesSince(mapVersion, changes)) {
+            *this = fromTileMap(tileMap);
+            return true;
+        }
+        try {
+            for (const TileChange& change : changes) {
+                const auto& tile = tileMap.getTile(change.index); // the tile as it is now; a cell changed twice is read twice
+                walkable[change.index] = tile && tile->getWalkable();
+            }
+        } catch (const std::exception& e) {
+            log_error("Failed to read changed tiles: " + std::string(e.what()));
+        }
+        mapVersion = tileMap.getVersion();
+        return true;
+    }
+}
@@ -0,0 +1,89 @@
+//
+//  navGrid.hpp
+//  sfml game template
+//
+//
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "../globals/globals.hpp"
+#include "../physics/physics.hpp"
+
+/* navigation namespace holds the pathfinding used by the auto-navigator and AI agents. Everything here searches a WalkGrid,
+a flat walkable/blocked byte per tile built once from a maze or tilemap, so searches never go through Tile objects */
+namespace navigation {
+
+    enum class Direction : std::uint8_t { None, Right, Down, Left, Up };
+
+    struct WalkGrid {
+        size_t width = 0;
+        size_t height = 0;
+        std::vector<std::uint8_t> walkable; // 1 where agents may stand
+        std::uint64_t mapVersion = 0; // the TileMap version it was built from or last synced with
+
+        static WalkGrid fromMaze(const Constants::MazeGrid& maze, const Constants::MazeTileKinds& kinds);
+        static WalkGrid fromTileMap(TileMap& tileMap);
+        static WalkGrid fromSnapshot(const MapSnapshot& snapshot); // for workers off the thread that edits the map
+        bool syncWith(TileMap& tileMap); // patches the tiles changed since mapVersion, or rebuilds past the journal; true if anything changed
+
+        size_t size() const { return walkable.size(); }
+        bool isWalkable(size_t index) const { return index < walkable.size() && walkable[index]; }
+
+        // calls visit(neighbor, direction) for each walkable 4-neighbour
+        template<typename Visit> void forEachNeighbor(size_t index, Visit&& visit) const {
+            size_t x = index % width;
+            if (x + 1 < width && walkable[index + 1]) visit(index + 1, Direction::Right);
+            if (index + width < walkable.size() && walkable[index + width]) visit(index + width, Direction::Down);
+            if (x > 0 && walkable[index - 1]) visit(index - 1, Direction::Left);
+            if (index >= width && walkable[index - width]) visit(index - width, Direction::Up);
+        }
+    };
+
+    /* whether a route may have been cut since tileMap was at version since: true when a change made since then landed on a tile
+    marked in routeTiles (1 per tile on the route), or when the journal no longer reaches back that far. changes is scratch */
+    bool routeTouchedSince(const TileMap& tileMap, std::uint64_t since, const std::vector<std::uint8_t>& routeTiles, std::vector<TileChange>& changes);
+
+    inline size_t stepIndex(size_t index, Direction direction, size_t width) {
+        switch (direction) {
+            case Direction::Right: return index + 1;
+            case Direction::Down: return index + width;
+            case Direction::Left: return index - 1;
+            case Direction::Up: return index - width;
+            default: return index;
+        }
+    }
+
+    inline Direction directionBetween(size_t from, size_t to, size_t width) { // None unless the tiles are 4-neighbours
+        bool sameRow = (from / width == to / width);
+        if (to == from + 1 && sameRow) return Direction::Right;
+        if (to == from + width) return Direction::Down;
+        if (from > 0 && to == from - 1 && sameRow) return Direction::Left;
+        if (from >= width && to == from - width) return Direction::Up;
+        return Direction::None;
+    }
+
+    inline float headingOf(Direction direction) { // degrees, the same convention as the player's heading angle
+        switch (direction) {
+            case Direction::Down: return 90.0f;
+            case Direction::Left: return 180.0f;
+            case Direction::Up: return 270.0f;
+            default: return 0.0f;
+        }
+    }
+
+    inline sf::Vector2f tileCenter(size_t index, const physics::NavigationGrid& geometry) {
+        return { geometry.origin.x + (index % geometry.width + 0.5f) * geometry.tileWidth,
+                 geometry.origin.y + (index / geometry.width + 0.5f) * geometry.tileHeight };
+    }
+
+    inline size_t tileIndexAt(sf::Vector2f position, const physics::NavigationGrid& geometry, size_t tileCount) { // tileCount when off the grid
+        float tileX = (position.x - geometry.origin.x) / geometry.tileWidth;
+        float tileY = (position.y - geometry.origin.y) / geometry.tileHeight;
+        if (tileX < 0.0f || tileY < 0.0f || tileX >= geometry.width) return tileCount;
+        size_t index = static_cast<size_t>(tileY) * geometry.width + static_cast<size_t>(tileX);
+        return index < tileCount ? index : tileCount;
+    }
+}
@@ -0,0 +1,81 @@
+//
+//  pathCache.cpp
+//  sfml game template
+//
+//
+
+#include "pathCache.hpp"
+
+#include <algorithm>
+
+namespace navigation {
+
+    size_t PathCache::find(size_t start, size_t goal, std::uint64_t version, std::vector<std::uint32_t>& out) {
+        const Key key { static_cast<std::uint32_t>(start), static_cast<std::uint32_t>(goal), version };
+        auto exact = lookup.find(key);
+        if (exact != lookup.end()) {
+            touch(exact->second);
+            out.insert(out.end(), exact->second->tiles.begin(), exact->second->tiles.end());
+            ++hits;
+            return exact->second->tiles.size();
+        }
+
+        auto sameGoal = byGoal.find({ 0, key.goal, version });
+        if (sameGoal != byGoal.end()) {
+            for (EntryList::iterator entry : sameGoal->second) {
+                auto through = std::find(entry->tiles.begin(), entry->tiles.end(), key.start);
+                if (through == entry->tiles.end()) continue;
+
+                touch(entry);
+                const size_t first = out.size();
+                out.insert(out.end(), through, entry->tiles.end());
+                insert(version, out.data() + first, out.data() + out.size()); // may evict entry, the tiles are already copied
+                ++hits;
+                ++suffixHits;
+                return out.size() - first;
+            }
+        }
+        ++misses;
+        return 0;
+    }
+
+    void PathCache::insert(std::uint64_t version, const std::uint32_t* first, const std::uint32_t* last) {
+        if (first == last) return;
+        const Key key { *first, *(last - 1), version };
+        auto existing = lookup.find(key);
+        if (existing != lookup.end()) {
+            touch(existing->second);
+            return;
+        }
+
+        while (entries.size() >= capacity) evict();
+        entries.push_front({ key, std::vector<std::uint32_t>(first, last) });
+        lookup.emplace(key, entries.begin());
+        byGoal[{ 0, key.goal, version }].push_back(entries.begin());
+    }
+
+    void PathCache::evict() {
+        EntryList::iterator oldest = std::prev(entries.end());
+        auto sameGoal = byGoal.find({ 0, oldest->key.goal, oldest->key.version });
+        if (sameGoal != byGoal.end()) {
+            auto& list = sameGoal->second;
+            auto position = std::find(list.begin(), list.end(), oldest);
+            if (position != list.end()) {
+                *position = list.back();
+                list.pop_back();
+            }
+            if (list.empty()) byGoal.erase(sameGoal);
+        }
+        lookup.erase(oldest->key);
+        entries.erase(oldest);
+    }
+
+    void PathCache::clear() {
+        entries.clear();
+        lookup.clear();
+        byGoal.clear();
+        hits = 0;
+        suffixHits = 0;
+        misses = 0;
+    }
+}
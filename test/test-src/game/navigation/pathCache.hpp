@@ -0,0 +1,67 @@
+//
+//  pathCache.hpp
+//  sfml game template
+//
+//
+
+#pragma once
+
+#include <list>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+namespace navigation {
+
+    constexpr size_t PATH_CACHE_CAPACITY = 512; // paths kept before the least recently used is dropped
+
+    /* bounded LRU of finished paths keyed by (start tile, goal tile, map version). The version is whatever the caller's map
+    counts changes with (TileMap::getVersion); a path found on an older version never matches again and simply ages out.
+    A miss on the exact key still hits if a cached path to the same goal on the same version passes through the start: a
+    shortest path's tail is itself a shortest path, so that suffix is returned and cached under its own key. solveMaze and the
+    findPaths overloads that take a cache consult it; AstarPath and thetaStar always search. Not thread safe */
+    class PathCache {
+    public:
+        explicit PathCache(size_t capacity = PATH_CACHE_CAPACITY) : capacity(capacity ? capacity : 1) {}
+
+        // appends the cached path (start first, goal last) to out and returns its length; 0 on a miss
+        size_t find(size_t start, size_t goal, std::uint64_t version, std::vector<std::uint32_t>& out);
+        void insert(std::uint64_t version, const std::uint32_t* first, const std::uint32_t* last); // a path, start first; empty paths are not kept
+        void clear(); // the paths and the hit and miss counts
+
+        size_t size() const { return entries.size(); }
+        size_t getHits() const { return hits; }
+        size_t getSuffixHits() const { return suffixHits; } // included in getHits
+        size_t getMisses() const { return misses; }
+
+    private:
+        struct Key {
+            std::uint32_t start, goal;
+            std::uint64_t version;
+            bool operator==(const Key& other) const { return start == other.start && goal == other.goal && version == other.version; }
+        };
+        struct KeyHash {
+            size_t operator()(const Key& key) const {
+                std::uint64_t tiles = (static_cast<std::uint64_t>(key.start) << 32) | key.goal;
+                return std::hash<std::uint64_t>()(tiles * 0x9E3779B97F4A7C15ull ^ key.version);
+            }
+        };
+        struct Entry {
+            Key key;
+            std::vector<std::uint32_t> tiles;
+        };
+        using EntryList = std::list<Entry>; // most recently used at the front
+
+        void touch(EntryList::iterator entry) { entries.splice(entries.begin(), entries, entry); }
+        void evict();
+
+        size_t capacity;
+        EntryList entries;
+        std::unordered_map<Key, EntryList::iterator, KeyHash> lookup;
+        std::unordered_map<Key, std::vector<EntryList::iterator>, KeyHash> byGoal; // start 0: every entry for a goal and version
+        size_t hits = 0;
+        size_t suffixHits = 0;
+        size_t misses = 0;
+    };
+}
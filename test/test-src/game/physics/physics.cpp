@@ -204,193 +204,475 @@ namespace physics {
             log_error("Tile or player is not initialized");
             return;
         }
-                                                                // std::cout << "tilepath instruction before: ";
-                                                                // for (auto i : tilePathInstruction) std::cout << i << " "; // for debugging
-                                                                // std::cout << "\n";
-
-        // Get the player's current position
-        sf::Vector2f currentPos = player->getSpritePos();
-        int tileX = static_cast<int>((currentPos.x - tileMap->getTileMapPosition().x) / tileMap->getTileWidth());
-        int tileY = static_cast<int>((currentPos.y - tileMap->getTileMapPosition().y) / tileMap->getTileHeight());
-        sf::Vector2i currentTile = {tileX, tileY};
-        size_t currentTileIndex = tileY * tileMap->getTileMapWidth() + tileX;
-
-                                                            //    std::cout << "Current index in map: " << currentTileIndex << "\n";
-
-        // Determine direction based on current angle
-        float playerAngle = player->getHeadingAngle();
-
-        if (playerAngle == 0.0f) physics::spriteMover(player, physics::moveRight);
-        else if (playerAngle == 90.0f) physics::spriteMover(player, physics::moveDown);
-        else if (playerAngle == 180.0f) physics::spriteMover(player, physics::moveLeft);
-        else if (playerAngle == 270.0f) physics::spriteMover(player, physics::moveUp);
-        
-        if (tilePathInstruction.empty()) {
-                                                    // std::cout << "Tile path instruction is empty. Goal tile reached.\n";
-            return; 
+
+        NavigationPose pose { player->getSpritePos(), player->getHeadingAngle() };
+        NavigationGrid grid { tileMap->getTileMapPosition(), tileMap->getTileWidth(), tileMap->getTileHeight(), tileMap->getTileMapWidth() };
+        navigateMaze(pose, player->getSpeed(), MetaComponents::deltaTime, grid, tilePathInstruction);
+
+        player->changePosition(pose.position);
+        player->updatePos();
+        if (pose.headingAngle != player->getHeadingAngle()) {
+            player->returnSpritesShape().setRotation(pose.headingAngle);
+            player->setHeadingAngle(player->returnSpritesShape().getRotation());
         }
+    }
 
-        // Recalculate player position after movement
-        currentPos = player->getSpritePos();
-        tileX = static_cast<int>((currentPos.x - tileMap->getTileMapPosition().x) / tileMap->getTileWidth());
-        tileY = static_cast<int>((currentPos.y - tileMap->getTileMapPosition().y) / tileMap->getTileHeight());
-        sf::Vector2i nextTile = {tileX, tileY};
-        size_t nextTileIndex = tileY * tileMap->getTileMapWidth() + tileX;
+    void navigateMaze(NavigationPose& pose, float speed, float deltaTime, const NavigationGrid& grid, std::vector<size_t>& tilePathInstruction) {
+        auto tileOf = [&grid](sf::Vector2f position) {
+            return sf::Vector2i{ static_cast<int>((position.x - grid.origin.x) / grid.tileWidth), static_cast<int>((position.y - grid.origin.y) / grid.tileHeight) };
+        };
 
-        bool autoNaviStart = false;
+        // Get the current tile
+        sf::Vector2i currentTile = tileOf(pose.position);
+        size_t currentTileIndex = currentTile.y * grid.width + currentTile.x;
 
-        if ((int)player->getHeadingAngle() % 90 != 0) {  // Check if player is off auto-path  
-                                                                //  std::cout << "Player is off auto path. Searching for closest valid tile...\n";
+        // Move along the current heading
+        float step = speed * deltaTime;
+        if (pose.headingAngle == 0.0f) pose.position.x += step;
+        else if (pose.headingAngle == 90.0f) pose.position.y += step;
+        else if (pose.headingAngle == 180.0f) pose.position.x -= step;
+        else if (pose.headingAngle == 270.0f) pose.position.y -= step;
+        
+        if (tilePathInstruction.empty()) return; // goal tile reached
 
+        // Recalculate tile after movement
+        sf::Vector2i nextTile = tileOf(pose.position);
+
+        bool autoNaviStart = false;
+
+        if (static_cast<int>(pose.headingAngle) % 90 != 0) {  // Check if player is off auto-path  
             // Check if current tile is part of the path
             auto it = std::find(tilePathInstruction.begin(), tilePathInstruction.end(), currentTileIndex);
 
             if (it == tilePathInstruction.end()) {
                 // Find the closest index in tilePathInstruction
-                auto closestIt = std::min_element(tilePathInstruction.begin(), tilePathInstruction.end(),
+                it = std::min_element(tilePathInstruction.begin(), tilePathInstruction.end(),
                     [currentTileIndex](size_t a, size_t b) {
                         return std::abs(static_cast<int>(a) - static_cast<int>(currentTileIndex)) <
                             std::abs(static_cast<int>(b) - static_cast<int>(currentTileIndex));
                     });
-
-                it = closestIt; // Use closestIt directly, no need to find it again
-                nextTileIndex = *closestIt; // Update nextTileIndex to the closest tile index
-                nextTile.x = static_cast<int>(nextTileIndex % tileMap->getTileMapWidth());
-                nextTile.y = static_cast<int>(nextTileIndex / tileMap->getTileMapWidth());
+                nextTile.x = static_cast<int>(*it % grid.width);
+                nextTile.y = static_cast<int>(*it / grid.width);
             }
 
-            if (it != tilePathInstruction.end() && std::next(it) != tilePathInstruction.end()) {
+            if (std::next(it) != tilePathInstruction.end()) {
                 tilePathInstruction.erase(std::next(it), tilePathInstruction.end());
             }
-            
-                                                                            // std::cout << "tilepath instruction after: ";
-                                                                            // for (auto i : tilePathInstruction) std::cout << i << " "; // for debugging
-                                                                            // std::cout << "\n";
-
-            player->returnSpritesShape().setRotation(0.0f); 
-            player->setHeadingAngle(player->returnSpritesShape().getRotation());
 
+            pose.headingAngle = 0.0f;
             autoNaviStart = true;
         }
 
         if ((currentTile != nextTile) || autoNaviStart) {
-            // Snap player to the center of the new tile
-            float tileCenterX = tileMap->getTileMapPosition().x + (nextTile.x * tileMap->getTileWidth()) + tileMap->getTileWidth() / 2.0f;
-            float tileCenterY = tileMap->getTileMapPosition().y + (nextTile.y * tileMap->getTileHeight()) + tileMap->getTileHeight() / 2.0f;
-            player->changePosition(sf::Vector2f{tileCenterX, tileCenterY});
-            player->updatePos(); // Update the player's position after snapping
+            // Snap to the center of the new tile
+            pose.position.x = grid.origin.x + (nextTile.x * grid.tileWidth) + grid.tileWidth / 2.0f;
+            pose.position.y = grid.origin.y + (nextTile.y * grid.tileHeight) + grid.tileHeight / 2.0f;
 
             if (!tilePathInstruction.empty()) {
                 // Get the next target tile from the path
                 size_t nextIndex = tilePathInstruction.back();
-                sf::Vector2i targetTile = { static_cast<int>(nextIndex % tileMap->getTileMapWidth()), static_cast<int>(nextIndex / tileMap->getTileMapWidth()) };
+                sf::Vector2i targetTile = { static_cast<int>(nextIndex % grid.width), static_cast<int>(nextIndex / grid.width) };
                 
                 if(!autoNaviStart) tilePathInstruction.pop_back();
 
                 // Determine direction based on the new target tile
-                if (targetTile.x < nextTile.x) player->returnSpritesShape().setRotation(180.0f); // Left
-                else if (targetTile.x > nextTile.x) player->returnSpritesShape().setRotation(0.0f); // Right
-                else if (targetTile.y < nextTile.y) player->returnSpritesShape().setRotation(270.0f); // Up
-                else if (targetTile.y > nextTile.y) player->returnSpritesShape().setRotation(90.0f); // Down
-
-                // Update the player's heading angle
-                player->setHeadingAngle(player->returnSpritesShape().getRotation());
-                                                                                //  std::cout << "next index" << nextIndex << "\n";
+                if (targetTile.x < nextTile.x) pose.headingAngle = 180.0f; // Left
+                else if (targetTile.x > nextTile.x) pose.headingAngle = 0.0f; // Right
+                else if (targetTile.y < nextTile.y) pose.headingAngle = 270.0f; // Up
+                else if (targetTile.y > nextTile.y) pose.headingAngle = 90.0f; // Down
             }
         }
+    }
+    
+    namespace {
+        sf::Vector2f headingVector(float headingAngle) {
+            if (headingAngle == 90.0f) return { 0.0f, 1.0f };
+            if (headingAngle == 180.0f) return { -1.0f, 0.0f };
+            if (headingAngle == 270.0f) return { 0.0f, -1.0f };
+            return { 1.0f, 0.0f };
+        }
 
-                                                                                // std::cout << "tilepath instruction after: ";
-                                                                                // for (auto i : tilePathInstruction) std::cout << i << " "; // for debugging
-                                                                                // std::cout << "\n";
+        sf::Vector2f tileCentre(size_t index, const NavigationGrid& grid) {
+            return { grid.origin.x + (index % grid.width + 0.5f) * grid.tileWidth, grid.origin.y + (index / grid.width + 0.5f) * grid.tileHeight };
         }
-    
+
+        sf::Vector2f segmentEnd(const PathSegment& segment, const NavigationGrid& grid) {
+            sf::Vector2f direction = headingVector(segment.headingAngle);
+            sf::Vector2f start = tileCentre(segment.startTile, grid);
+            return { start.x + direction.x * grid.tileWidth * segment.length, start.y + direction.y * grid.tileHeight * segment.length };
+        }
+
+        size_t tileAlong(const PathSegment& segment, size_t tilesIn, size_t mapWidth) { // the tile that many tiles into the run
+            size_t step = (segment.headingAngle == 0.0f || segment.headingAngle == 180.0f) ? 1 : mapWidth;
+            bool backwards = (segment.headingAngle == 180.0f || segment.headingAngle == 270.0f);
+            return backwards ? segment.startTile - tilesIn * step : segment.startTile + tilesIn * step;
+        }
+
+        // how many tiles along the segment the tile lies, or -1 when it is not on it
+        long tilesAlong(const PathSegment& segment, size_t tile, size_t mapWidth) {
+            long startX = static_cast<long>(segment.startTile % mapWidth), startY = static_cast<long>(segment.startTile / mapWidth);
+            long x = static_cast<long>(tile % mapWidth), y = static_cast<long>(tile / mapWidth);
+            sf::Vector2f direction = headingVector(segment.headingAngle);
+            long along = direction.x != 0.0f ? (x - startX) * static_cast<long>(direction.x) : (y - startY) * static_cast<long>(direction.y);
+            bool onLine = direction.x != 0.0f ? (y == startY) : (x == startX);
+            return (onLine && along >= 0 && along <= static_cast<long>(segment.length)) ? along : -1;
+        }
+    }
+
+    std::vector<PathSegment> compressPath(const std::vector<size_t>& tilePathInstruction, size_t mapWidth) {
+        std::vector<PathSegment> segments;
+        if (tilePathInstruction.size() < 2) return segments;
+
+        // the instruction runs goal to start, so walk it from the back
+        for (size_t i = tilePathInstruction.size() - 1; i > 0; --i) {
+            size_t from = tilePathInstruction[i], to = tilePathInstruction[i - 1];
+            float headingAngle = (to == from + 1) ? 0.0f : (to == from + mapWidth) ? 90.0f : (to + 1 == from) ? 180.0f : 270.0f;
+            if (!segments.empty() && segments.back().headingAngle == headingAngle) ++segments.back().length;
+            else segments.push_back({ static_cast<std::uint32_t>(from), headingAngle, 1 });
+        }
+        std::reverse(segments.begin(), segments.end());
+        return segments;
+    }
+
+    bool rejoinPathSegments(NavigationPose& pose, const NavigationGrid& grid, std::vector<PathSegment>& segments) {
+        if (segments.empty()) return false;
+
+        sf::Vector2f local = pose.position - grid.origin;
+        size_t tile = static_cast<size_t>(std::max(0.0f, local.y / grid.tileHeight)) * grid.width + static_cast<size_t>(std::max(0.0f, local.x / grid.tileWidth));
+
+        // still on the current run, and on its centre line
+        const PathSegment& current = segments.back();
+        sf::Vector2f offset = pose.position - tileCentre(current.startTile, grid);
+        float lateral = headingVector(current.headingAngle).x != 0.0f ? offset.y : offset.x;
+        if (tilesAlong(current, tile, grid.width) >= 0 && std::abs(lateral) < 0.001f * grid.tileWidth) return false;
+
+        // the route tile the pose stands on, else the one closest by index (as the tile navigator picks it)
+        size_t bestSegment = segments.size() - 1;
+        long bestAlong = 0;
+        long bestDistance = -1;
+        for (size_t i = segments.size(); i-- > 0;) {
+            long along = tilesAlong(segments[i], tile, grid.width);
+            if (along >= 0) { bestSegment = i; bestAlong = along; bestDistance = 0; break; }
+
+            for (size_t k = 0; k <= segments[i].length; ++k) {
+                size_t routeTile = tileAlong(segments[i], k, grid.width);
+                long distance = std::abs(static_cast<long>(routeTile) - static_cast<long>(tile));
+                if (bestDistance < 0 || distance < bestDistance) { bestSegment = i; bestAlong = static_cast<long>(k); bestDistance = distance; }
+            }
+        }
+
+        // drop the runs before it, start the run from the rejoin tile
+        segments.erase(segments.begin() + bestSegment + 1, segments.end());
+        PathSegment& rejoined = segments.back();
+        rejoined.startTile = static_cast<std::uint32_t>(tileAlong(rejoined, static_cast<size_t>(bestAlong), grid.width));
+        rejoined.length -= static_cast<std::uint32_t>(bestAlong);
+        pose.position = tileCentre(rejoined.startTile, grid);
+        if (rejoined.length == 0) segments.pop_back();
+        return true;
+    }
+
+    bool followPathSegments(NavigationPose& pose, float speed, float deltaTime, const NavigationGrid& grid, std::vector<PathSegment>& segments) {
+        float remaining = speed * deltaTime;
+        while (!segments.empty()) {
+            const PathSegment& segment = segments.back();
+            sf::Vector2f direction = headingVector(segment.headingAngle);
+            sf::Vector2f end = segmentEnd(segment, grid);
+            float toEnd = (end.x - pose.position.x) * direction.x + (end.y - pose.position.y) * direction.y;
+            pose.headingAngle = segment.headingAngle;
+
+            if (toEnd > remaining) {
+                pose.position += direction * remaining;
+                return true;
+            }
+            // turn: finish this run and carry the rest of the step into the next one
+            pose.position = end;
+            remaining -= std::max(0.0f, toEnd);
+            segments.pop_back();
+        }
+        return false;
+    }
+
+    void navigateMaze(std::unique_ptr<Player>& player, std::unique_ptr<TileMap>& tileMap, std::vector<PathSegment>& segments) {
+        if (!player || !tileMap) {
+            log_error("Tile or player is not initialized");
+            return;
+        }
+
+        NavigationPose pose { player->getSpritePos(), player->getHeadingAngle() };
+        NavigationGrid grid { tileMap->getTileMapPosition(), tileMap->getTileWidth(), tileMap->getTileHeight(), tileMap->getTileMapWidth() };
+        rejoinPathSegments(pose, grid, segments);
+        followPathSegments(pose, player->getSpeed(), MetaComponents::deltaTime, grid, segments);
+
+        player->changePosition(pose.position);
+        player->updatePos();
+        if (pose.headingAngle != player->getHeadingAngle()) {
+            player->returnSpritesShape().setRotation(pose.headingAngle);
+            player->setHeadingAngle(player->returnSpritesShape().getRotation());
+        }
+    }
+
     void calculateRayCast3d(std::unique_ptr<Player>& player, std::unique_ptr<TileMap>& tileMap, sf::VertexArray& lines, sf::VertexArray& wallLine) {
-        if(!player || !tileMap){
+        if(!player){
             log_error("tile or player is not initialized");
             return;
         }
+        calculateRayCast3d(player->getSpritePos(), player->getHeadingAngle(), tileMap, lines, wallLine);
+    }
 
-        float startX = player->getSpritePos().x;
-        float startY = player->getSpritePos().y;
-        float playerAngle = player->getHeadingAngle(); // Player's rotation angle in degrees
+    /* wallMipLevel picks the largest level that still has at least one texel per screen pixel, so a far wall reads a small
+    level that stays in cache and its texels are not skipped (which is what made distant walls shimmer) */
+    size_t wallMipLevel(float texelsPerPixel, size_t levelCount) {
+        if (levelCount == 0 || !(texelsPerPixel > 1.0f)) return 0;
+        return std::min(static_cast<size_t>(std::log2(texelsPerPixel)), levelCount - 1);
+    }
 
-        size_t itCount = Constants::RAYS_NUM / 2;
-        float screenWidth = static_cast<float>(MetaComponents::bigView.getSize().x);
-        float screenHeight = static_cast<float>(MetaComponents::bigView.getSize().y);
-        float centerY = screenHeight / 2.0f;
+    void calculateRayCast3d(sf::Vector2f origin, float headingAngle, std::unique_ptr<TileMap>& tileMap, sf::VertexArray& lines, sf::VertexArray& wallLine) {
+        if(!tileMap){
+            log_error("tile or player is not initialized");
+            return;
+        }
+        thread_local ColumnHits hits;
+        castColumns(origin, headingAngle, *tileMap, hits);
+        buildRayLines(hits, lines);
+        buildWallQuads(hits, wallLine);
+    }
 
-        const float wallHeightScale = 2500.0f;  // Scale factor for wall height
-        float angleStep = Constants::FOV / static_cast<float>(itCount);  // Angle step between rays
-        const float maxRayDistance = 1000.0f; // Maximum allowed ray distance to prevent infinite loops
+    void ColumnHits::resize(size_t columns) {
+        rayAngle.resize(columns);
+        distance.resize(columns);
+        correctedDistance.resize(columns);
+        end.resize(columns);
+        tile.resize(columns);
+        tileType.resize(columns);
+        face.resize(columns);
+        faceCoordinate.resize(columns);
+    }
 
-        wallLine.clear();
-        wallLine.setPrimitiveType(sf::Quads);  // Use quads for filled walls
-        lines.clear();
-        lines.setPrimitiveType(sf::Lines);
-        lines.resize(2 * itCount); // Ensure enough space for ray visualization
+    namespace {
+        // what every column of every camera shares for one cast; the map is read from a snapshot, so edits made meanwhile on
+        // another thread do not reach a cast half way
+        struct CastSetup {
+            explicit CastSetup(TileMap& tileMap)
+                : map(tileMap.snapshot()), columns(Constants::RAYS_NUM / 2), angleStep(Constants::FOV / static_cast<float>(Constants::RAYS_NUM / 2)),
+                  tileWidth(static_cast<int>(tileMap.getTileWidth())), tileHeight(static_cast<int>(tileMap.getTileHeight())),
+                  mapWidth(static_cast<int>(tileMap.getTileMapWidth())), mapHeight(static_cast<int>(tileMap.getTileMapHeight())) {}
+
+            MapSnapshotHandle map;
+            size_t columns;
+            float angleStep; // Angle step between rays
+            int tileWidth, tileHeight, mapWidth, mapHeight;
+            static constexpr float maxRayDistance = 1000.0f; // Maximum allowed ray distance to prevent infinite loops
+        };
 
-        float sliceWidth = screenWidth / static_cast<float>(itCount); // Corrected wall slice width
+        void prepareHits(const CastSetup& setup, sf::Vector2f origin, float headingAngle, ColumnHits& hits) {
+            hits.origin = origin;
+            hits.headingAngle = headingAngle;
+            hits.resize(setup.columns);
+        }
 
-        for (size_t i = 0; i < itCount; ++i) {
-            float angleOffset = (i - itCount / 2.0f) * angleStep;
-            float rayAngle = playerAngle + angleOffset;
+        // marches column i of hits' camera in unit steps until it enters a wall tile, leaves the map or runs out of range
+        void castColumn(const CastSetup& setup, ColumnHits& hits, size_t i, VisibleTiles* visible) {
+            const sf::Vector2f origin = hits.origin;
+            const float headingAngle = hits.headingAngle;
+            float rayAngle = headingAngle + (i - setup.columns / 2.0f) * setup.angleStep;
             float radian = rayAngle * 3.14159f / 180.0f; // Convert to radians
-
             float dirX = cos(radian);
             float dirY = sin(radian);
-            float stepSize = 1.0f;
+            const float stepSize = 1.0f;
 
-            float rayX = startX;
-            float rayY = startY;
-            bool hit = false;
+            float rayX = origin.x;
+            float rayY = origin.y;
             float rayDistance = 0.0f;
+            hits.rayAngle[i] = rayAngle;
+            hits.end[i] = origin;
+            hits.face[i] = WallFace::None;
+            size_t lastTile = SIZE_MAX;
 
-            while (!hit && rayDistance < maxRayDistance) {
+            while (rayDistance < CastSetup::maxRayDistance) {
                 rayX += dirX * stepSize;
                 rayY += dirY * stepSize;
                 rayDistance += stepSize;
 
-                int tileX = static_cast<int>(rayX) / tileMap->getTileWidth();
-                int tileY = static_cast<int>(rayY) / tileMap->getTileHeight();
+                int tileX = static_cast<int>(rayX) / setup.tileWidth;
+                int tileY = static_cast<int>(rayY) / setup.tileHeight;
+                if (tileX < 0 || tileY < 0 || tileX >= setup.mapWidth || tileY >= setup.mapHeight) break; // Exit if ray goes out of bounds
+                hits.end[i] = sf::Vector2f(rayX, rayY);
 
-                if (tileX < 0 || tileY < 0 || tileX >= tileMap->getTileMapWidth() || tileY >= tileMap->getTileMapHeight()) break; // Exit if ray goes out of bounds
-            
-                // Store raycasting lines for debugging (2D representation)
-                lines[2 * i].position = sf::Vector2f(startX, startY);
-                lines[2 * i + 1].position = sf::Vector2f(rayX, rayY);
-                lines[2 * i].color = sf::Color::Red;
-                lines[2 * i + 1].color = sf::Color::Red;
-
-                auto& tile = tileMap->getTile(tileY * tileMap->getTileMapWidth() + tileX);
-
-                if (!tile->getWalkable()) { hit = true;
-
-                // Correct fish-eye effect
-                float correctedDistance = rayDistance * cos((rayAngle - playerAngle) * 3.14159f / 180.0f);
-                correctedDistance = std::max(1.0f, correctedDistance); // Prevent division by zero or extreme values
-
-                // Compute projected wall height
-                float wallHeight = wallHeightScale / correctedDistance;
-
-                // Compute screen position for this wall slice
-                float screenX = i * sliceWidth;
-                float wallTopY = centerY - wallHeight / 2.0f;
-                float wallBottomY = centerY + wallHeight / 2.0f;
-
-                // Adjust brightness based on distance
-                const float maxDistance = 100.0f; // Adjust based on game scale
-                float brightnessFactor = std::max(0.2f, 1.0f - (correctedDistance / maxDistance));
-                sf::Uint8 color = static_cast<sf::Uint8>(50 + 150 * brightnessFactor);
-               // sf::Color wallColor(0, static_cast<sf::Uint8>(50 + 150 * brightnessFactor), 0);
-                sf::Color wallColor(color, color, color);
-
-                // Define quad vertices for the wall slice
-                wallLine.append(sf::Vertex(sf::Vector2f(screenX, wallTopY), wallColor)); // Top Left
-                wallLine.append(sf::Vertex(sf::Vector2f(screenX + sliceWidth, wallTopY), wallColor)); // Top Right
-                wallLine.append(sf::Vertex(sf::Vector2f(screenX + sliceWidth, wallBottomY), wallColor)); // Bottom Right
-                wallLine.append(sf::Vertex(sf::Vector2f(screenX, wallBottomY), wallColor)); // Bottom Left
+                size_t tileIndex = static_cast<size_t>(tileY) * setup.mapWidth + tileX;
+                if (visible && tileIndex != lastTile) {
+                    visible->insert(tileIndex);
+                    lastTile = tileIndex;
                 }
+                if (setup.map->isWalkable(tileX, tileY)) continue;
+
+                // the face the ray came in through: a side face if the last step crossed a column boundary, else top or bottom.
+                // The face coordinate runs left to right as seen from the ray, so a texture reads the same way round from both sides
+                const bool sideFace = static_cast<int>(rayX - dirX * stepSize) / setup.tileWidth != tileX;
+                float along = sideFace ? std::fmod(rayY, static_cast<float>(setup.tileHeight)) / setup.tileHeight : std::fmod(rayX, static_cast<float>(setup.tileWidth)) / setup.tileWidth;
+                if (sideFace ? dirX < 0.0f : dirY > 0.0f) along = 1.0f - along;
+
+                hits.tile[i] = static_cast<std::uint32_t>(tileIndex);
+                hits.tileType[i] = setup.map->tileType(tileX, tileY);
+                hits.face[i] = sideFace ? (dirX > 0.0f ? WallFace::West : WallFace::East) : (dirY > 0.0f ? WallFace::North : WallFace::South);
+                hits.faceCoordinate[i] = along;
+                // Correct fish-eye effect; at least 1 to prevent division by zero or extreme values
+                hits.correctedDistance[i] = std::max(1.0f, rayDistance * cos((rayAngle - headingAngle) * 3.14159f / 180.0f));
+                break;
             }
+            hits.distance[i] = rayDistance;
+        }
+
+        bool tileOf(const CastSetup& setup, sf::Vector2f point, int& tileX, int& tileY) {
+            if (point.x < 0.0f || point.y < 0.0f) return false;
+            tileX = static_cast<int>(point.x) / setup.tileWidth;
+            tileY = static_cast<int>(point.y) / setup.tileHeight;
+            return tileX < setup.mapWidth && tileY < setup.mapHeight;
+        }
+
+        // a ray is straight, so its tiles lie in the box of its first and last ones: the bounds need only the origin and the ends
+        void boundVisible(const CastSetup& setup, const ColumnHits& hits, VisibleTiles& visible) {
+            int tileX = 0, tileY = 0;
+            if (tileOf(setup, hits.origin, tileX, tileY)) {
+                visible.insert(static_cast<size_t>(tileY) * setup.mapWidth + tileX); // the rays may step out of it before marking it
+                visible.growBounds(tileX, tileY);
+            }
+            for (size_t i = 0; i < hits.size(); ++i) {
+                if (tileOf(setup, hits.end[i], tileX, tileY)) visible.growBounds(tileX, tileY);
+            }
+        }
+    }
+
+    void VisibleTiles::reset(size_t mapWidth, size_t mapHeight) {
+        if (mapWidth != width || mapHeight != height) {
+            width = mapWidth;
+            height = mapHeight;
+            wordCount = (width * height + 63) / 64;
+            words.reset(new std::atomic<std::uint64_t>[wordCount]);
+            for (size_t i = 0; i < wordCount; ++i) words[i].store(0, std::memory_order_relaxed);
+        } else if (!empty()) {
+            // every set bit is inside the last bounds, so clearing its rows' words is enough
+            const size_t first = static_cast<size_t>(bounds.top) * width / 64;
+            const size_t last = (static_cast<size_t>(bounds.top + bounds.height) * width + 63) / 64;
+            for (size_t i = first; i < std::min(last, wordCount); ++i) words[i].store(0, std::memory_order_relaxed);
+        }
+        bounds = sf::IntRect();
+    }
+
+    void VisibleTiles::growBounds(int tileX, int tileY) {
+        if (empty()) {
+            bounds = sf::IntRect(tileX, tileY, 1, 1);
+            return;
+        }
+        const int right = std::max(bounds.left + bounds.width, tileX + 1);
+        const int bottom = std::max(bounds.top + bounds.height, tileY + 1);
+        bounds.left = std::min(bounds.left, tileX);
+        bounds.top = std::min(bounds.top, tileY);
+        bounds.width = right - bounds.left;
+        bounds.height = bottom - bounds.top;
+    }
+
+    bool VisibleTiles::contains(int tileX, int tileY) const {
+        if (tileX < 0 || tileY < 0 || static_cast<size_t>(tileX) >= width || static_cast<size_t>(tileY) >= height) return false;
+        return contains(static_cast<size_t>(tileY) * width + tileX);
+    }
+
+    size_t VisibleTiles::count() const {
+        size_t total = 0;
+        for (size_t i = 0; i < wordCount; ++i) total += static_cast<size_t>(__builtin_popcountll(words[i].load(std::memory_order_relaxed)));
+        return total;
+    }
+
+    // columns are independent, so they are marched on the job system; each writes only its own slot of every array
+    void castColumns(sf::Vector2f origin, float headingAngle, TileMap& tileMap, ColumnHits& hits, VisibleTiles* visible) {
+        const CastSetup setup(tileMap);
+        if (!setup.map) {
+            log_error("Tile map has no snapshot to cast against");
+            return;
+        }
+        prepareHits(setup, origin, headingAngle, hits);
+        if (visible) visible->reset(setup.mapWidth, setup.mapHeight);
+        jobs::engineJobs().parallelFor(0, setup.columns, [&](size_t i) { castColumn(setup, hits, i, visible); }, RAYCAST_COLUMN_GRAIN);
+        if (visible) boundVisible(setup, hits, *visible);
+    }
+
+    /* every camera's columns go into one dispatch, camera after camera, so chunks are shared out over all of them and a
+    view costs its column work and nothing more; a chunk may finish one camera and start the next */
+    void castColumns(const std::vector<CameraPose>& cameras, TileMap& tileMap, std::vector<ColumnHits>& hits, VisibleTiles* visible) {
+        const CastSetup setup(tileMap);
+        if (!setup.map) {
+            log_error("Tile map has no snapshot to cast against");
+            return;
+        }
+        hits.resize(cameras.size());
+        for (size_t camera = 0; camera < cameras.size(); ++camera) prepareHits(setup, cameras[camera].origin, cameras[camera].headingAngle, hits[camera]);
+        if (visible) visible->reset(setup.mapWidth, setup.mapHeight);
+        if (setup.columns != 0) jobs::engineJobs().parallelForRange(0, cameras.size() * setup.columns, [&](size_t rangeBegin, size_t rangeEnd) {
+            size_t camera = rangeBegin / setup.columns;
+            size_t column = rangeBegin % setup.columns;
+            for (size_t k = rangeBegin; k < rangeEnd; ++k) {
+                castColumn(setup, hits[camera], column, visible);
+                if (++column == setup.columns) { column = 0; ++camera; }
+            }
+        }, RAYCAST_COLUMN_GRAIN);
+        if (visible) {
+            for (const ColumnHits& cameraHits : hits) boundVisible(setup, cameraHits, *visible);
+        }
+    }
+
+    // buildRayLines draws every column's ray from the origin to where it stopped, for the 2D debug view
+    void buildRayLines(const ColumnHits& hits, sf::VertexArray& lines) {
+        lines.clear();
+        lines.setPrimitiveType(sf::Lines);
+        lines.resize(2 * hits.size());
+        for (size_t i = 0; i < hits.size(); ++i) {
+            lines[2 * i] = sf::Vertex(hits.origin, sf::Color::Red);
+            lines[2 * i + 1] = sf::Vertex(hits.end[i], sf::Color::Red);
+        }
+    }
+
+    /* buildWallQuads turns every hit column into a wall slice, in column order: its height from the corrected distance,
+    darker with distance, textured from the hit tile's level of the tile mip chain when that was built. It reads only the hits, so
+    the texture follows the tile type the cast saw, not whatever the live map holds by now */
+    void buildWallQuads(const ColumnHits& hits, sf::VertexArray& wallLine) {
+        float screenWidth = static_cast<float>(MetaComponents::bigView.getSize().x);
+        float screenHeight = static_cast<float>(MetaComponents::bigView.getSize().y);
+        float centerY = screenHeight / 2.0f;
+        const float wallHeightScale = 2500.0f;  // Scale factor for wall height
+        const float maxDistance = 100.0f; // distance at which walls are darkest; adjust based on game scale
+        float sliceWidth = hits.size() ? screenWidth / static_cast<float>(hits.size()) : 0.0f;
+        const std::vector<sf::Vector2u>& mipOffsets = Constants::TILES_MIP_OFFSETS;
+        const std::vector<sf::IntRect>& tileRects = Constants::TILES_SINGLE_RECTS;
+
+        wallLine.clear();
+        wallLine.setPrimitiveType(sf::Quads);  // Use quads for filled walls
+        for (size_t i = 0; i < hits.size(); ++i) {
+            if (hits.face[i] == WallFace::None) continue;
+
+            // Compute projected wall height and the screen position of this wall slice
+            float wallHeight = wallHeightScale / hits.correctedDistance[i];
+            float screenX = i * sliceWidth;
+            float wallTopY = centerY - wallHeight / 2.0f;
+            float wallBottomY = centerY + wallHeight / 2.0f;
+
+            // Adjust brightness based on distance
+            float brightnessFactor = std::max(0.2f, 1.0f - (hits.correctedDistance[i] / maxDistance));
+            sf::Uint8 color = static_cast<sf::Uint8>(50 + 150 * brightnessFactor);
+            sf::Color wallColor(color, color, color);
+
+            sf::Vector2f texStart, texEnd;
+            if (!mipOffsets.empty() && hits.tileType[i] < tileRects.size()) {
+                const sf::IntRect textureRect = tileRects[hits.tileType[i]];
+                const size_t level = wallMipLevel(textureRect.height / wallHeight, mipOffsets.size());
+                const float levelScale = 1.0f / static_cast<float>(1u << level);
+                const float texelColumn = std::floor((textureRect.left + std::min(hits.faceCoordinate[i], 0.999f) * textureRect.width) * levelScale) + 0.5f;
+                texStart = { mipOffsets[level].x + texelColumn, mipOffsets[level].y + textureRect.top * levelScale };
+                texEnd = { texStart.x, texStart.y + textureRect.height * levelScale };
+            }
+
+            wallLine.append(sf::Vertex(sf::Vector2f(screenX, wallTopY), wallColor, texStart)); // Top Left
+            wallLine.append(sf::Vertex(sf::Vector2f(screenX + sliceWidth, wallTopY), wallColor, texStart)); // Top Right
+            wallLine.append(sf::Vertex(sf::Vector2f(screenX + sliceWidth, wallBottomY), wallColor, texEnd)); // Bottom Right
+            wallLine.append(sf::Vertex(sf::Vector2f(screenX, wallBottomY), wallColor, texEnd)); // Bottom Left
         }
     }
     
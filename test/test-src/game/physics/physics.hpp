@@ -10,9 +10,12 @@
 #include <math.h>
 #include <functional> 
 #include <utility>
+#include <cstdint>
+#include <atomic>
 
 #include "../../test-assets/sprites/sprites.hpp" 
 #include "../../test-assets/tiles/tiles.hpp" 
+#include "../jobs/jobs.hpp"
 
 
 namespace physics{
@@ -97,9 +100,97 @@ namespace physics{
     }
 
     // for 3D calculations
+    constexpr size_t RAYCAST_COLUMN_GRAIN = 16; // columns per job chunk when rays are cast in parallel
+    enum class WallFace : std::uint8_t { None, West, East, North, South }; // side of the hit tile the ray came in through; None: no hit
+
+    /* what each screen column sees, from one raycast: struct of arrays, an entry per column (Constants::RAYS_NUM / 2 of them,
+    left to right). The wall quads and the 2D ray lines are built from it, and anything else that needs sight lines (audio
+    occlusion, AI, sprite clipping) can read the same cast instead of casting again */
+    struct ColumnHits {
+        sf::Vector2f origin;
+        float headingAngle = 0.0f;
+        std::vector<float> rayAngle; // degrees
+        std::vector<float> distance; // along the ray to the wall, or to where the ray stopped
+        std::vector<float> correctedDistance; // along the view direction (no fish-eye), at least 1; hits only
+        std::vector<sf::Vector2f> end; // last point of the ray inside the map
+        std::vector<std::uint32_t> tile; // wall tile index; hits only
+        std::vector<std::uint16_t> tileType; // the wall tile's type in the snapshot the cast read; hits only
+        std::vector<WallFace> face;
+        std::vector<float> faceCoordinate; // 0..1 across the face, left to right as seen by the ray; hits only
+
+        size_t size() const { return face.size(); }
+        void resize(size_t columns);
+    };
+
+    struct CameraPose {
+        sf::Vector2f origin;
+        float headingAngle = 0.0f; // degrees
+    };
+
+    /* the tiles a cast's rays passed through, the wall tiles they hit included, as one bit per map tile, plus the box (in
+    tiles) around them. Marked by the columns while they march, so culling follows exactly what the view can see; anything
+    on a tile outside it (sprites, entity updates, sounds) can be skipped for the frame */
+    class VisibleTiles {
+    public:
+        // empty again, sized for a mapWidth x mapHeight map; on the same map only the words under the last bounds are cleared
+        void reset(size_t mapWidth, size_t mapHeight);
+        void insert(size_t tile) {
+            std::atomic<std::uint64_t>& word = words[tile / 64];
+            const std::uint64_t bit = std::uint64_t(1) << (tile % 64);
+            if (!(word.load(std::memory_order_relaxed) & bit)) word.fetch_or(bit, std::memory_order_relaxed); // most steps revisit a marked tile
+        }
+        void growBounds(int tileX, int tileY); // not thread safe; the cast calls it once the columns are done
+
+        bool contains(size_t tile) const { return tile < width * height && (words[tile / 64].load(std::memory_order_relaxed) >> (tile % 64)) & 1; }
+        bool contains(int tileX, int tileY) const;
+        bool empty() const { return bounds.width == 0; }
+        sf::IntRect getBounds() const { return bounds; } // in tiles; width 0 when nothing was seen
+        size_t count() const;
+
+    private:
+        std::unique_ptr<std::atomic<std::uint64_t>[]> words;
+        size_t wordCount = 0;
+        size_t width = 0, height = 0;
+        sf::IntRect bounds;
+    };
+
+    // the optional visible set is reset and filled by the cast; with several cameras it is what any of them sees
+    void castColumns(sf::Vector2f origin, float headingAngle, TileMap& tileMap, ColumnHits& hits, VisibleTiles* visible = nullptr);
+    void castColumns(const std::vector<CameraPose>& cameras, TileMap& tileMap, std::vector<ColumnHits>& hits, VisibleTiles* visible = nullptr); // hits[i] for cameras[i], one parallel dispatch
+    void buildRayLines(const ColumnHits& hits, sf::VertexArray& lines);
+    void buildWallQuads(const ColumnHits& hits, sf::VertexArray& wallLine);
+
+    // cast and build both vertex arrays in one call
     void calculateRayCast3d(std::unique_ptr<Player>& player, std::unique_ptr<TileMap>& tileMap, sf::VertexArray& rays, sf::VertexArray& wallLine);
+    void calculateRayCast3d(sf::Vector2f origin, float headingAngle, std::unique_ptr<TileMap>& tileMap, sf::VertexArray& rays, sf::VertexArray& wallLine); // from an arbitrary (e.g. interpolated) pose
+    size_t wallMipLevel(float texelsPerPixel, size_t levelCount); // the level of Constants::TILES_MIP_TEXTURE a wall column samples
     void navigateMaze(std::unique_ptr<Player>& player, std::unique_ptr<TileMap>& tileMap, std::vector<size_t>& tilePathInstruction);
 
+    // plain-data auto-navigator behind the one above; runs without sprites or a tilemap (headless benchmarks)
+    struct NavigationPose {
+        sf::Vector2f position;
+        float headingAngle = 0.0f; // degrees; the navigator only moves on 0, 90, 180 and 270
+    };
+    struct NavigationGrid {
+        sf::Vector2f origin;
+        float tileWidth = 0.0f;
+        float tileHeight = 0.0f;
+        size_t width = 0; // in tiles
+    };
+    void navigateMaze(NavigationPose& pose, float speed, float deltaTime, const NavigationGrid& grid, std::vector<size_t>& tilePathInstruction);
+
+    /* corridor form of a tile path: one segment per straight run, so following it only does work at turns instead of
+    popping and re-snapping on every tile boundary */
+    struct PathSegment {
+        std::uint32_t startTile = 0; // runs from the centre of this tile
+        float headingAngle = 0.0f; // 0, 90, 180 or 270
+        std::uint32_t length = 0; // in tiles
+    };
+    std::vector<PathSegment> compressPath(const std::vector<size_t>& tilePathInstruction, size_t mapWidth); // same order as the instruction: next segment at the back
+    bool rejoinPathSegments(NavigationPose& pose, const NavigationGrid& grid, std::vector<PathSegment>& segments); // snaps onto the route if the pose left it; true when it did
+    bool followPathSegments(NavigationPose& pose, float speed, float deltaTime, const NavigationGrid& grid, std::vector<PathSegment>& segments); // false once the route is done
+    void navigateMaze(std::unique_ptr<Player>& player, std::unique_ptr<TileMap>& tileMap, std::vector<PathSegment>& segments);
+
     // collision methods
     bool circleCollision(const sf::Vector2f pos1, float radius1, const sf::Vector2f pos2, float radius2);
     // raycast pre-collision in 2D space
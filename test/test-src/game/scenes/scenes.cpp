@@ -1,4 +1,5 @@
 #include "scenes.hpp"
+#include "../navigation/corridorGraph.hpp"
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -18,8 +19,15 @@ Scene::Scene( sf::RenderWindow& gameWindow ) : window(gameWindow), quadtree(0.0f
 }
 
 void Scene::runScene() {
+    runSimulationTick();
+    renderFrame();
+}
+
+// advances the scene by one fixed step (MetaComponents::deltaTime); never draws
+void Scene::runSimulationTick() {
     if (FlagSystem::flagEvents.gameEnd) return; // Early exit if game ended
     
+    storePreviousState();
     setTime();
 
     handleInput();
@@ -31,14 +39,20 @@ void Scene::runScene() {
     handleSceneFlags();
 
     update();
+}
+
+void Scene::renderFrame() {
     draw();
 }
 
-void Scene::draw(){
+void Scene::draw(){ // presenting is left to GameWindow::present, which paces it
     window.clear(sf::Color::Black);
-    window.display(); 
  }
 
+void Scene::recordFrame(FrameSnapshot& frame){
+    frame.reset(sf::Color::Black);
+}
+
 void Scene::moveViewPortWASD(){
     // move view port 
     if(FlagSystem::flagEvents.aPressed){
@@ -114,6 +128,7 @@ void gamePlayScene::createAssets() {
         tileMap1 = std::make_unique<TileMap>(tiles1.data(), Constants::TILES_NUMBER, Constants::TILEMAP_WIDTH, Constants::TILEMAP_HEIGHT, Constants::TILE_WIDTH, Constants::TILE_HEIGHT, Constants::TILEMAP_FILEPATH, Constants::TILEMAP_POSITION); 
         rays = sf::VertexArray(sf::Lines, Constants::RAYS_NUM);
         rays = sf::VertexArray(sf::Quads, Constants::RAYS_NUM);
+        setAutoPath();
    
         // Music
         backgroundMusic = std::make_unique<MusicClass>(std::move(Constants::BACKGROUNDMUSIC_MUSIC), Constants::BACKGROUNDMUSIC_VOLUME);
@@ -126,9 +141,12 @@ void gamePlayScene::createAssets() {
         introText = std::make_unique<TextClass>(Constants::TEXT_POSITION, Constants::TEXT_SIZE, Constants::TEXT_COLOR, Constants::TEXT_FONT, Constants::TEXT_MESSAGE);
         scoreText = std::make_unique<TextClass>(Constants::SCORETEXT_POSITION, Constants::SCORETEXT_SIZE, Constants::SCORETEXT_COLOR, Constants::TEXT_FONT, Constants::SCORETEXT_MESSAGE);
         endingText = std::make_unique<TextClass>(Constants::ENDINGTEXT_POSITION, Constants::ENDINGTEXT_SIZE, Constants::ENDINGTEXT_COLOR, Constants::TEXT_FONT, Constants::ENDINGTEXT_MESSAGE);
+        frameStatsText = std::make_unique<TextClass>(Constants::STATSTEXT_POSITION, Constants::STATSTEXT_SIZE, Constants::STATSTEXT_COLOR, Constants::TEXT_FONT, "");
+        frameStatsText->setVisibleState(Constants::SHOW_FRAME_STATS);
 
         insertItemsInQuadtree(); 
         setInitialTimes();
+        storePreviousState();
 
         globalTimer.End("initializing assets in scene 1"); // for logging purposes
     } 
@@ -137,6 +155,12 @@ void gamePlayScene::createAssets() {
     }
 }
 
+void gamePlayScene::storePreviousState(){
+    if (!player) return; 
+    previousPlayerPos = player->getSpritePos();
+    previousPlayerAngle = player->getHeadingAngle();
+}
+
 void gamePlayScene::setInitialTimes(){
 
 }
@@ -203,14 +227,14 @@ void gamePlayScene::handleMovementKeys() {
     // std::cout << "Tile X: " << tileX << ", Tile Y: " << tileY << ", inex: " << tileIndexInMap << "can walk: "<< canWalkOnTile<< std::endl;
     
     if(FlagSystem::flagEvents.aPressed){ // turn left
-        player->returnSpritesShape().rotate(-1.0f); // degrees
+        player->returnSpritesShape().rotate(-Constants::SPRITE1_TURN_SPEED * MetaComponents::deltaTime); // degrees
         float newAngle = player->returnSpritesShape().getRotation();
         player->setHeadingAngle(newAngle);
         FlagSystem::gameScene1Flags.begin = true;
        // player->setAutoNavigate(false); // stop auto navigation
     }
     if(FlagSystem::flagEvents.dPressed){ // turn right 
-        player->returnSpritesShape().rotate(1.0f); // degrees
+        player->returnSpritesShape().rotate(Constants::SPRITE1_TURN_SPEED * MetaComponents::deltaTime); // degrees
         float newAngle = player->returnSpritesShape().getRotation();
         player->setHeadingAngle(newAngle);
         FlagSystem::gameScene1Flags.begin = true;
@@ -251,10 +275,13 @@ void gamePlayScene::handleMovementKeys() {
 void gamePlayScene::handleGameEvents() { 
     // scoreText->getText().setPosition(MetaComponents::smallView.getCenter().x - 460, MetaComponents::smallView.getCenter().y - 270);
     if(button1->getClickedBool() && player && player->getMoveState()){
-        physics::navigateMaze(player, tileMap1, Constants::TILEPATH_INSTRUCTION);
+        physics::navigateMaze(player, tileMap1, autoPathSegments);
         player->setAutoNavigate(true); 
     }
-    physics::calculateRayCast3d(player, tileMap1, rays, wallLine); // modifies the ray 
+
+    int tileX = static_cast<int>((player->getSpritePos().x - Constants::TILEMAP_POSITION.x) / Constants::TILE_WIDTH);
+    int tileY = static_cast<int>((player->getSpritePos().y - Constants::TILEMAP_POSITION.y) / Constants::TILE_HEIGHT);
+    if(tileY * Constants::TILEMAP_WIDTH + tileX == Constants::TILEMAP_GOALINDEX) FlagSystem::flagEvents.gameEnd = true; // checked at the simulated position, once per tick
 } 
 
 void gamePlayScene::handleSceneFlags(){
@@ -271,16 +298,48 @@ void gamePlayScene::update() {
         handleInvisibleSprites();
 
         updatePlayerAndView(); 
+        syncAutoPath(); 
+        if (tileMap1) tileMap1->publishSnapshot(); // this tick's map edits, for the raycast and any worker
         quadtree.update(); 
-
-        // Set the view for the window
-        window.setView(MetaComponents::smallView);
         
     } catch (const std::exception& e) {
         log_error("Exception in updateSprites: " + std::string(e.what()));
     }
 }
 
+// auto navigation follows Constants::TILEPATH_INSTRUCTION as it is now, and watches the tilemap's changes from here on
+void gamePlayScene::setAutoPath() {
+    autoPathSegments = physics::compressPath(Constants::TILEPATH_INSTRUCTION, Constants::TILEMAP_WIDTH);
+    autoPathTiles.assign(Constants::TILEMAP_WIDTH * Constants::TILEMAP_HEIGHT, 0);
+    for (size_t tile : Constants::TILEPATH_INSTRUCTION) if (tile < autoPathTiles.size()) autoPathTiles[tile] = 1;
+    if (tileMap1) autoPathVersion = tileMap1->getVersion();
+}
+
+/* the auto navigation route only has to change when a tile on it did: the map's journal is read for the changes since the
+route was solved, and the route is solved again, from the player's tile, only if one of them is on it (or the journal no
+longer reaches back) */
+void gamePlayScene::syncAutoPath() {
+    if (!tileMap1 || !player || tileMap1->getVersion() == autoPathVersion) return;
+
+    const bool onRoute = navigation::routeTouchedSince(*tileMap1, autoPathVersion, autoPathTiles, mapChanges);
+    autoPathVersion = tileMap1->getVersion();
+    if (!onRoute) return;
+
+    const Constants::MazeTileKinds kinds { Constants::TILE_STARTINGINDEX, Constants::TILE_ENDINGINDEX, Constants::TILE_WALKABLEINDEX, Constants::TILE_WALLINDEX };
+    Constants::MazeGrid maze(tileMap1->getTileMapWidth(), tileMap1->getTileMapHeight());
+    for (size_t i = 0; i < maze.tiles.size(); ++i) {
+        const std::uint16_t type = tileMap1->getTileType(i);
+        maze.tiles[i] = type == kinds.starting ? kinds.walkable : type;
+    }
+    const physics::NavigationGrid geometry { tileMap1->getTileMapPosition(), tileMap1->getTileWidth(), tileMap1->getTileHeight(), tileMap1->getTileMapWidth() };
+    const size_t playerTile = navigation::tileIndexAt(player->getSpritePos(), geometry, maze.tiles.size());
+    if (playerTile < maze.tiles.size()) maze.tiles[playerTile] = kinds.starting;
+
+    Constants::TILEPATH_INSTRUCTION = navigation::solveMaze(maze, kinds, autoPathCache, tileMap1->getVersion());
+    setAutoPath();
+    log_info("Map changed on the auto navigation route; route solved again (" + std::to_string(Constants::TILEPATH_INSTRUCTION.size()) + " tiles)");
+}
+
 void gamePlayScene::updateEntityStates(){ // manually change the sprite's state
    
 }
@@ -307,71 +366,112 @@ void gamePlayScene::updateDrawablesVisibility(){
 // Draws only the visible sprite and texts
 void gamePlayScene::draw() {
     try {
-        window.clear(sf::Color::Black); // set the base baskground color black
+        recordFrame(directFrame);
+        directFrame.replay(window);
+    } 
+    catch (const std::exception& e) {
+        log_error("Exception in draw: " + std::string(e.what()));
+    }
+}
 
-        drawInBigView();
-        drawInSmallView();
+// Records the frame at the interpolated pose; used directly by draw() and by the simulation thread in pipelined mode
+void gamePlayScene::recordFrame(FrameSnapshot& snapshot) {
+    try {
+        applyInterpolatedPose(); 
+        if (tileMap1) {
+            physics::castColumns(player->returnSpritesShape().getPosition(), player->returnSpritesShape().getRotation(), *tileMap1, columnHits, &visibleTiles);
+            physics::buildRayLines(columnHits, rays);
+            physics::buildWallQuads(columnHits, wallLine);
+        }
+
+        snapshot.reset(sf::Color::Black); // set the base baskground color black
 
-        window.display(); 
+        drawInBigView(snapshot);
+        drawInSmallView(snapshot);
+
+        restoreSimulatedPose(); 
     } 
     catch (const std::exception& e) {
-        log_error("Exception in draw: " + std::string(e.what()));
+        restoreSimulatedPose(); 
+        log_error("Exception in recordFrame: " + std::string(e.what()));
     }
 }
 
-void gamePlayScene::drawInBigView(){
-    window.setView(MetaComponents::bigView);
+void gamePlayScene::showFrameStats(const std::string& statsLine) {
+    if (frameStatsText && Constants::SHOW_FRAME_STATS) frameStatsText->getText().setString(statsLine);
+}
+
+// moves the player's sprite (not its simulated position) to where it is between the last two ticks
+void gamePlayScene::applyInterpolatedPose() {
+    const float alpha = MetaComponents::interpolationAlpha;
+    const sf::Vector2f currentPos = player->getSpritePos();
+    const float currentAngle = player->getHeadingAngle();
+
+    float angleDelta = std::fmod(currentAngle - previousPlayerAngle + 540.0f, 360.0f) - 180.0f; // shortest way around
+    float angle = std::fmod(previousPlayerAngle + angleDelta * alpha + 360.0f, 360.0f);
+
+    player->returnSpritesShape().setPosition(previousPlayerPos + (currentPos - previousPlayerPos) * alpha);
+    player->returnSpritesShape().setRotation(angle);
+}
+
+void gamePlayScene::restoreSimulatedPose() {
+    player->updatePos(); 
+    player->returnSpritesShape().setRotation(player->getHeadingAngle());
+}
+
+void gamePlayScene::drawInBigView(FrameSnapshot& snapshot){
+    snapshot.beginLayer(MetaComponents::bigView);
 
     int tileX = static_cast<int>((player->getSpritePos().x - Constants::TILEMAP_POSITION.x) / Constants::TILE_WIDTH);
     int tileY = static_cast<int>((player->getSpritePos().y - Constants::TILEMAP_POSITION.y) / Constants::TILE_HEIGHT);
     int tileIndexInMap = tileY * Constants::TILEMAP_WIDTH + tileX;
 
-    if(tileIndexInMap == Constants::TILEMAP_PLAYERSPAWNINDEX){ 
-        drawVisibleObject(backgroundBigStart);
-    } else if (tileIndexInMap == Constants::TILEMAP_GOALINDEX){ 
-        FlagSystem::flagEvents.gameEnd = true;
-        drawVisibleObject(backgroundBigFinal);
-        drawVisibleObject(endingText);
+    if(FlagSystem::flagEvents.gameEnd){ // set by the tick that reached the goal
+        drawVisibleObject(snapshot, backgroundBigFinal);
+        drawVisibleObject(snapshot, endingText);
+    } else if(tileIndexInMap == Constants::TILEMAP_PLAYERSPAWNINDEX){ 
+        drawVisibleObject(snapshot, backgroundBigStart);
     } else {
-        drawVisibleObject(backgroundBig);
+        drawVisibleObject(snapshot, backgroundBig);
     }
-    window.draw(wallLine);
+    snapshot.add(TexturedVertices(wallLine, Constants::TILES_MIP_OFFSETS.empty() ? nullptr : Constants::TILES_MIP_TEXTURE.get()));
 
-  //  drawVisibleObject(bullets[0]); 
-    drawVisibleObject(frame); 
-    drawVisibleObject(scoreText); 
-    drawVisibleObject(introText);
+  //  drawVisibleObject(snapshot, bullets[0]); 
+    drawVisibleObject(snapshot, frame); 
+    drawVisibleObject(snapshot, scoreText); 
+    drawVisibleObject(snapshot, introText);
 
     if(FlagSystem::flagEvents.mPressed){
         sf::RectangleShape mainRect(sf::Vector2f(Constants::VIEW_SIZE_X, Constants::VIEW_SIZE_Y));
         mainRect.setFillColor(sf::Color::Magenta); // background for small view
         mainRect.setPosition(0,0);
 
-        window.draw(mainRect);
+        snapshot.add(mainRect);
 
-        drawVisibleObject(tileMap1);
-        drawVisibleObject(player);
+        drawVisibleObject(snapshot, tileMap1);
+        drawVisibleObject(snapshot, player);
 
-        window.draw(rays); 
+        snapshot.add(sf::VertexArray(rays)); 
     }
 
-    drawVisibleObject(button1);
+    drawVisibleObject(snapshot, button1);
+    drawVisibleObject(snapshot, frameStatsText);
 }
 
-void gamePlayScene::drawInSmallView(){
+void gamePlayScene::drawInSmallView(FrameSnapshot& snapshot){
     if(!FlagSystem::flagEvents.mPressed){
-        window.setView(MetaComponents::smallView);
+        snapshot.beginLayer(MetaComponents::smallView);
 
         // temporary 
         sf::RectangleShape mainRect(sf::Vector2f(Constants::VIEW_SIZE_X, Constants::VIEW_SIZE_Y));
         mainRect.setFillColor(sf::Color::Magenta); // background for small view
         mainRect.setPosition(0,0);
 
-        window.draw(mainRect);
+        snapshot.add(mainRect);
 
-        drawVisibleObject(tileMap1);
-        drawVisibleObject(player);
+        drawVisibleObject(snapshot, tileMap1);
+        drawVisibleObject(snapshot, player);
 
-        window.draw(rays); 
+        snapshot.add(sf::VertexArray(rays)); 
     }
 }
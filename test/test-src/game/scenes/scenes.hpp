@@ -14,6 +14,7 @@
 #include "../physics/physics.hpp"             
 #include "../utils/utils.hpp"                 
 #include "../camera/window.hpp"
+#include "../navigation/pathCache.hpp"
 
 // Base scene class 
 class Scene {
@@ -22,7 +23,10 @@ public:
   virtual ~Scene() = default; 
 
   // base functions inside scene
-  void runScene();  
+  void runScene(); // one simulation tick followed by a render
+  void runSimulationTick(); 
+  void renderFrame(); 
+  virtual void recordFrame(FrameSnapshot& frame); // everything draw() would show, copied into frame (pipelined rendering)
   virtual void createAssets(){}; 
 
 protected:
@@ -30,6 +34,7 @@ protected:
   FlagSystem::SceneEvents sceneEvents; // scene's own flag events
 
   // blank templates here
+  virtual void storePreviousState(){}; // snapshot of poses at the start of a tick, for render interpolation
   virtual void setInitialTimes(){};
   virtual void insertItemsInQuadtree(){}; 
   virtual void handleInvisibleSprites(){};  
@@ -61,8 +66,13 @@ public:
   ~gamePlayScene() override = default; 
  
   void createAssets() override; 
+  void recordFrame(FrameSnapshot& snapshot) override; 
+  void showFrameStats(const std::string& statsLine); // overlay text, only shown when Constants::SHOW_FRAME_STATS
+  const physics::ColumnHits& getColumnHits() const { return columnHits; } // the last frame's raycast
+  const physics::VisibleTiles& getVisibleTiles() const { return visibleTiles; } // tiles the last frame's rays passed through, for culling
 
 private:
+  void storePreviousState() override; 
   void setInitialTimes() override;
   void insertItemsInQuadtree() override; 
 
@@ -82,15 +92,33 @@ private:
   void update() override; 
   void updateDrawablesVisibility() override; 
   void updatePlayerAndView(); 
+  void setAutoPath(); 
+  void syncAutoPath(); 
   void updateEntityStates(); 
   void changeAnimation();
 
   void draw() override; 
-  void drawInBigView();
-  void drawInSmallView();
+  void applyInterpolatedPose(); 
+  void restoreSimulatedPose(); 
+  void drawInBigView(FrameSnapshot& snapshot);
+  void drawInSmallView(FrameSnapshot& snapshot);
 
+  // records a copy of the drawable's current look; the tilemap as quads built from its last published snapshot
   template<typename drawableType>
-  void drawVisibleObject(drawableType& drawable){ if (drawable && drawable->getVisibleState()) window.draw(*drawable); }
+  void drawVisibleObject(FrameSnapshot& snapshot, drawableType& drawable){ 
+    if (!drawable || !drawable->getVisibleState()) return;
+    using objectType = std::decay_t<decltype(*drawable)>;
+    if constexpr (std::is_base_of_v<Sprite, objectType>) snapshot.add(sf::Sprite(drawable->returnSpritesShape()));
+    else if constexpr (std::is_same_v<objectType, TextClass>) snapshot.add(sf::Text(drawable->getText()));
+    else {
+      const MapSnapshotHandle published = drawable->snapshot();
+      if (published && published != tileMapVerticesSource) { // rebuilt only when the map published edits
+        drawable->buildVertices(*published, tileMapVertices);
+        tileMapVerticesSource = published;
+      }
+      snapshot.add(TexturedVertices(tileMapVertices, Constants::TILES_TEXTURE.get()));
+    }
+  }
 
   std::unique_ptr<Player> player; 
   std::vector<std::unique_ptr<Bullet>> bullets; 
@@ -103,10 +131,21 @@ private:
   
   std::array<std::shared_ptr<Tile>, Constants::TILES_NUMBER> tiles1;   
   std::unique_ptr<TileMap> tileMap1; 
-
-  // for 3d walls
+  std::vector<physics::PathSegment> autoPathSegments; // Constants::TILEPATH_INSTRUCTION as straight runs, consumed by auto navigation
+  std::vector<std::uint8_t> autoPathTiles; // 1 on the tiles of TILEPATH_INSTRUCTION
+  std::uint64_t autoPathVersion = 0; // tileMap1 version the route was solved for
+  std::vector<TileChange> mapChanges; // reused by syncAutoPath
+  navigation::PathCache autoPathCache; // routes syncAutoPath solved, keyed by tileMap1's version
+
+  // for 3d walls; one cast per frame, the vertex arrays are built from it
+  physics::ColumnHits columnHits;
+  physics::VisibleTiles visibleTiles;
   sf::VertexArray rays;
   sf::VertexArray wallLine; 
+  sf::VertexArray tileMapVertices; // tileMap1 as of tileMapVerticesSource, copied into the frames that show it
+  MapSnapshotHandle tileMapVerticesSource;
+
+  FrameSnapshot directFrame; // reused by draw() when rendering on this thread
 
   std::unique_ptr<MusicClass> backgroundMusic;
   std::unique_ptr<SoundClass> buttonClickSound; 
@@ -114,6 +153,11 @@ private:
   std::unique_ptr<TextClass> introText; 
   std::unique_ptr<TextClass> scoreText; 
   std::unique_ptr<TextClass> endingText; 
+  std::unique_ptr<TextClass> frameStatsText; 
 
   float beginTime{};
+
+  // player pose at the start of the current tick; draw() interpolates from here to the simulated pose
+  sf::Vector2f previousPlayerPos{};
+  float previousPlayerAngle{};
 };
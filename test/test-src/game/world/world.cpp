@@ -0,0 +1,99 @@
+//
+//  world.cpp
+//  sfml game template
+//
+//
+
+#include "world.hpp"
+#include "../navigation/corridorGraph.hpp"
+
+namespace world {
+
+    WorldSettings WorldSettings::fromConfig(std::uint32_t seed, MazeGenerator generator) {
+        WorldSettings settings;
+        settings.mazeWidth = Constants::TILEMAP_WIDTH;
+        settings.mazeHeight = Constants::TILEMAP_HEIGHT;
+        settings.seed = seed;
+        settings.generator = generator;
+        settings.tileKinds = { Constants::TILE_STARTINGINDEX, Constants::TILE_ENDINGINDEX, Constants::TILE_WALKABLEINDEX, Constants::TILE_WALLINDEX };
+        settings.grid = { Constants::TILEMAP_POSITION, static_cast<float>(Constants::TILE_WIDTH), static_cast<float>(Constants::TILE_HEIGHT), Constants::TILEMAP_WIDTH };
+        settings.playerSpeed = Constants::SPRITE1_SPEED;
+        settings.deltaTime = Constants::FIXED_TIME_STEP;
+        return settings;
+    }
+
+// WorldInstance
+    WorldInstance::WorldInstance(const WorldSettings& worldSettings) : settings(worldSettings), maze(worldSettings.mazeWidth, worldSettings.mazeHeight) {
+        settings.grid.width = maze.width;
+        flags.gameEnd = false;
+
+        std::mt19937 rng(settings.seed);
+        if (settings.generator == MazeGenerator::Prim) Constants::PrimsMazeGrid(maze, settings.tileKinds, rng);
+        else Constants::DFSmazeGrid(maze, settings.tileKinds, rng);
+
+        std::vector<size_t> tilePath = navigation::solveMaze(maze, settings.tileKinds);
+        if (tilePath.empty()) return; // no tick limit, so the run is finished before it starts
+        pathLength = tilePath.size();
+        goalIndex = tilePath.front();
+        tickLimit = pathLength * settings.maxTicksPerTile;
+
+        route = physics::compressPath(tilePath, maze.width);
+        const size_t spawnIndex = tilePath.back();
+        player.position = { settings.grid.origin.x + (spawnIndex % maze.width + 0.5f) * settings.grid.tileWidth,
+                            settings.grid.origin.y + (spawnIndex / maze.width + 0.5f) * settings.grid.tileHeight };
+        if (!route.empty()) player.headingAngle = route.back().headingAngle;
+    }
+
+    bool WorldInstance::step() {
+        if (isFinished()) return false;
+
+        physics::followPathSegments(player, settings.playerSpeed, settings.deltaTime, settings.grid, route);
+        globalTime += settings.deltaTime;
+        ++ticks;
+
+        if (playerTileIndex() == goalIndex) {
+            reached = true;
+            flags.gameEnd = true;
+        }
+        return !isFinished();
+    }
+
+    size_t WorldInstance::playerTileIndex() const {
+        float tileX = (player.position.x - settings.grid.origin.x) / settings.grid.tileWidth;
+        float tileY = (player.position.y - settings.grid.origin.y) / settings.grid.tileHeight;
+        if (tileX < 0.0f || tileY < 0.0f || tileX >= maze.width || tileY >= maze.height) return maze.tiles.size(); // off the maze
+        return static_cast<size_t>(tileY) * maze.width + static_cast<size_t>(tileX);
+    }
+
+// batches
+    Worlds createWorlds(const std::vector<WorldSettings>& settings, jobs::JobSystem& system, BatchResult* result) {
+        Timer createTimer;
+        Worlds worlds(settings.size());
+        system.parallelFor(0, settings.size(), [&](size_t i) { worlds[i] = std::make_unique<WorldInstance>(settings[i]); }, 1);
+        if (result) result->createMs = createTimer.ElapsedMillis();
+        return worlds;
+    }
+
+    BatchResult runBatch(Worlds& worlds, jobs::JobSystem& system, size_t sliceTicks) {
+        BatchResult result;
+        result.worlds = worlds.size();
+        Timer runTimer;
+
+        // every world is stepped by one job at a time and touches nothing shared, so slices need no locking
+        bool anyRunning = true;
+        while (anyRunning) {
+            system.parallelFor(0, worlds.size(), [&worlds, sliceTicks](size_t i) {
+                for (size_t tick = 0; tick < sliceTicks && worlds[i]->step(); ++tick) {}
+            });
+            anyRunning = std::any_of(worlds.begin(), worlds.end(), [](const auto& world) { return !world->isFinished(); });
+        }
+
+        result.runMs = runTimer.ElapsedMillis();
+        for (const auto& world : worlds) {
+            result.ticks += world->getTicks();
+            if (world->reachedGoal()) ++result.solved;
+        }
+        result.ticksPerSecond = result.runMs > 0.0 ? result.ticks / (result.runMs / 1000.0) : 0.0;
+        return result;
+    }
+}
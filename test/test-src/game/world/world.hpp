@@ -0,0 +1,85 @@
+//
+//  world.hpp
+//  sfml game template
+//
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "../globals/globals.hpp"
+#include "../physics/physics.hpp"
+#include "../jobs/jobs.hpp"
+
+/* world namespace holds self-contained playthroughs for bot runs. A WorldInstance owns everything the game otherwise keeps in
+process-wide globals (maze, path, player pose, timing, flags), so any number of them can be stepped side by side, and a batch
+of them is spread over the job system's threads. Instances only read Constants, and only while being created */
+namespace world {
+
+    enum class MazeGenerator : std::uint8_t { DFS, Prim };
+
+    struct WorldSettings {
+        size_t mazeWidth = 0; // in tiles, odd
+        size_t mazeHeight = 0;
+        std::uint32_t seed = 1;
+        MazeGenerator generator = MazeGenerator::DFS;
+        Constants::MazeTileKinds tileKinds {};
+        physics::NavigationGrid grid {}; // width is filled in from mazeWidth
+        float playerSpeed = 0.0f;
+        float deltaTime = 0.0f; // fixed tick length
+        size_t maxTicksPerTile = 1000; // a run that takes longer than this per path tile is given up on
+
+        static WorldSettings fromConfig(std::uint32_t seed, MazeGenerator generator = MazeGenerator::DFS); // Constants must be loaded
+    };
+
+    class WorldInstance {
+    public:
+        explicit WorldInstance(const WorldSettings& settings); // generates the maze and solves it
+        bool step(); // advances one tick; false once the run is finished
+        bool isFinished() const { return flags.gameEnd || ticks >= tickLimit; }
+        bool reachedGoal() const { return reached; }
+
+        std::uint64_t getTicks() const { return ticks; }
+        float getGlobalTime() const { return globalTime; }
+        size_t getPathLength() const { return pathLength; }
+        const physics::NavigationPose& getPlayerPose() const { return player; }
+        const Constants::MazeGrid& getMaze() const { return maze; }
+        const FlagSystem::FlagEvents& getFlags() const { return flags; }
+        const WorldSettings& getSettings() const { return settings; }
+
+    private:
+        size_t playerTileIndex() const;
+
+        WorldSettings settings;
+        Constants::MazeGrid maze;
+        std::vector<physics::PathSegment> route; // next run at the back
+        size_t goalIndex = 0;
+        size_t pathLength = 0;
+        physics::NavigationPose player;
+        FlagSystem::FlagEvents flags;
+        float globalTime = 0.0f;
+        std::uint64_t ticks = 0;
+        std::uint64_t tickLimit = 0;
+        bool reached = false;
+    };
+
+    struct BatchResult {
+        size_t worlds = 0;
+        size_t solved = 0;
+        std::uint64_t ticks = 0;
+        double createMs = 0.0;
+        double runMs = 0.0;
+        double ticksPerSecond = 0.0; // simulation ticks per wall-clock second while running
+    };
+
+    using Worlds = std::vector<std::unique_ptr<WorldInstance>>;
+
+    constexpr size_t BATCH_SLICE_TICKS = 1200; // ticks a job advances one world before the batch checks what is left
+
+    Worlds createWorlds(const std::vector<WorldSettings>& settings, jobs::JobSystem& system = jobs::engineJobs(), BatchResult* result = nullptr);
+    BatchResult runBatch(Worlds& worlds, jobs::JobSystem& system = jobs::engineJobs(), size_t sliceTicks = BATCH_SLICE_TICKS);
+}
@@ -1,9 +1,30 @@
 
+#include <iostream>
+
 #include "game/core/game.hpp"
 
-int main(){
-    Constants::initialize(); 
+// usage: sfml_game_test [--record <file>] [--replay <file>]
+int main(int argc, char* argv[]){
+    GameManager::RunOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        std::filesystem::path* value = flag == "--record" ? &options.recordPath : flag == "--replay" ? &options.replayPath : nullptr;
+        if (!value || i + 1 == argc) { // a typo must not start an unrecorded session, nor replay nothing
+            std::cerr << (value ? "missing file after " : "unknown option ") << flag << "\nusage: " << argv[0] << " [--record <file>] [--replay <file>]\n";
+            return 1;
+        }
+        *value = argv[++i];
+    }
+
+    std::uint32_t mazeSeed = 0; // a replay has to run in the maze it was recorded in
+    if (!options.replayPath.empty()) {
+        replay::Header header;
+        if (!replay::readHeader(options.replayPath, header)) return 1;
+        mazeSeed = header.mazeSeed;
+    }
+
+    Constants::initialize(mazeSeed); 
 
-    GameManager game1; 
+    GameManager game1(options); 
     game1.runGame();
 }